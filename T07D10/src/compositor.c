@@ -0,0 +1,374 @@
+#include "compositor.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "matrix_ops.h"
+
+#define SHOWN_UNKNOWN INT_MIN
+#define PRESENT_BUFFER (1 << 16)
+#define PRESENT_RESERVE 64
+#define RUN_GAP 3
+
+typedef struct present_buffer {
+    FILE *out;
+    char data[PRESENT_BUFFER];
+    size_t len;
+    long total;
+} present_buffer;
+
+int min_int(int a, int b) { return a < b ? a : b; }
+
+int max_int(int a, int b) { return a > b ? a : b; }
+
+long rect_area(rect area) { return (long)area.width * area.height; }
+
+rect rect_bounds(rect a, rect b) {
+    rect result;
+    result.x = min_int(a.x, b.x);
+    result.y = min_int(a.y, b.y);
+    result.width = max_int(a.x + a.width, b.x + b.width) - result.x;
+    result.height = max_int(a.y + a.height, b.y + b.height) - result.y;
+    return result;
+}
+
+/*
+    Two dirty rectangles are merged when they overlap, or when their bounding
+    box covers no cell outside them (e.g. neighbours along a whole edge).
+*/
+int should_merge(rect a, rect b) {
+    int overlap = a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+    return overlap || rect_area(rect_bounds(a, b)) <= rect_area(a) + rect_area(b);
+}
+
+int canvas_create(canvas *target, int width, int height, int background) {
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+    target->width = width;
+    target->height = height;
+    target->background = background;
+    target->dirty_count = 0;
+    target->cell_width = CANVAS_CELL_WIDTH;
+    target->cells = matrix_create(height, width);
+    target->shown = matrix_create(height, width);
+    if (target->cells == NULL || target->shown == NULL) {
+        canvas_free(target);
+        return 0;
+    }
+
+    for (long i = 0; i < (long)width * height; i++) {
+        target->cells[0][i] = background;
+        target->shown[0][i] = SHOWN_UNKNOWN;
+    }
+    rect whole = {0, 0, width, height};
+    canvas_mark(target, whole);
+    return 1;
+}
+
+void canvas_free(canvas *target) {
+    free(target->cells);
+    free(target->shown);
+    target->cells = NULL;
+    target->shown = NULL;
+    target->dirty_count = 0;
+}
+
+void canvas_mark(canvas *target, rect area) {
+    int left = max_int(area.x, 0), top = max_int(area.y, 0);
+    area.width = min_int(area.x + area.width, target->width) - left;
+    area.height = min_int(area.y + area.height, target->height) - top;
+    area.x = left;
+    area.y = top;
+    if (area.width <= 0 || area.height <= 0) {
+        return;
+    }
+
+    int i = 0;
+    while (i < target->dirty_count) {
+        if (should_merge(target->dirty[i], area)) {
+            area = rect_bounds(target->dirty[i], area);
+            target->dirty[i] = target->dirty[--target->dirty_count];
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+
+    if (target->dirty_count == CANVAS_MAX_DIRTY) {
+        int best = 0;
+        long best_growth = -1;
+        for (i = 0; i < target->dirty_count; i++) {
+            long growth = rect_area(rect_bounds(target->dirty[i], area)) - rect_area(target->dirty[i]);
+            if (best_growth < 0 || growth < best_growth) {
+                best = i;
+                best_growth = growth;
+            }
+        }
+        area = rect_bounds(target->dirty[best], area);
+        target->dirty[best] = target->dirty[--target->dirty_count];
+        canvas_mark(target, area);
+    } else {
+        target->dirty[target->dirty_count++] = area;
+    }
+}
+
+/*
+    Draws the part of image at (x, y) that falls inside clip, which must lie
+    within the canvas.
+*/
+void blit_clipped(canvas *target, const sprite *image, int x, int y, rect clip) {
+    int left = max_int(x, clip.x), right = min_int(x + image->width, clip.x + clip.width);
+    int top = max_int(y, clip.y), bottom = min_int(y + image->height, clip.y + clip.height);
+    int key = image->transparent;
+
+    for (int row = top; row < bottom && left < right; row++) {
+        const int *source = image->pixels + (size_t)(row - y) * image->width + (left - x);
+        int *dest = target->cells[row] + left;
+        if (key == SPRITE_OPAQUE) {
+            memcpy(dest, source, (right - left) * sizeof(int));
+        } else {
+            for (int i = 0; i < right - left; i++) {
+                dest[i] = (source[i] != key) ? source[i] : dest[i];
+            }
+        }
+    }
+}
+
+void canvas_blit(canvas *target, const sprite *image, int x, int y) {
+    rect area = {x, y, image->width, image->height};
+    rect whole = {0, 0, target->width, target->height};
+    blit_clipped(target, image, x, y, whole);
+    canvas_mark(target, area);
+}
+
+void buffer_flush(present_buffer *buffer) {
+    fwrite(buffer->data, 1, buffer->len, buffer->out);
+    buffer->total += (long)buffer->len;
+    buffer->len = 0;
+}
+
+void buffer_int(present_buffer *buffer, int value) {
+    char digits[12];
+    int len = 0;
+    unsigned magnitude = (value < 0) ? 0u - (unsigned)value : (unsigned)value;
+    do {
+        digits[len++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        digits[len++] = '-';
+    }
+    while (len > 0) {
+        buffer->data[buffer->len++] = digits[--len];
+    }
+}
+
+/*
+    Moves the cursor to cell (row, col) and writes cells [col, end) of the row.
+*/
+void present_run(present_buffer *buffer, const int *cells, int row, int col, int end, int cell_width) {
+    if (buffer->len + PRESENT_RESERVE > PRESENT_BUFFER) {
+        buffer_flush(buffer);
+    }
+    memcpy(buffer->data + buffer->len, "\x1b[", 2);
+    buffer->len += 2;
+    buffer_int(buffer, row + 1);
+    buffer->data[buffer->len++] = ';';
+    buffer_int(buffer, col * cell_width + 1);
+    buffer->data[buffer->len++] = 'H';
+
+    for (int j = col; j < end; j++) {
+        if (buffer->len + PRESENT_RESERVE > PRESENT_BUFFER) {
+            buffer_flush(buffer);
+        }
+        size_t start = buffer->len;
+        buffer_int(buffer, cells[j]);
+        while (buffer->len - start < (size_t)cell_width) {
+            buffer->data[buffer->len++] = ' ';
+        }
+    }
+}
+
+int int_width(int value) {
+    int width = (value < 0) ? 2 : 1;
+    unsigned magnitude = (value < 0) ? 0u - (unsigned)value : (unsigned)value;
+    while (magnitude >= 10) {
+        magnitude /= 10;
+        width++;
+    }
+    return width;
+}
+
+/*
+    Widens the cells when a changed value doesn't fit with its separating
+    space. The columns of every shown cell move then, so the whole canvas is
+    forgotten and marked dirty.
+*/
+void fit_cell_width(canvas *target) {
+    int widest = 0;
+    for (int d = 0; d < target->dirty_count; d++) {
+        rect area = target->dirty[d];
+        for (int row = area.y; row < area.y + area.height; row++) {
+            for (int j = area.x; j < area.x + area.width; j++) {
+                if (target->cells[row][j] != target->shown[row][j]) {
+                    widest = max_int(widest, int_width(target->cells[row][j]));
+                }
+            }
+        }
+    }
+    if (widest + 1 > target->cell_width) {
+        target->cell_width = widest + 1;
+        for (long i = 0; i < (long)target->width * target->height; i++) {
+            target->shown[0][i] = SHOWN_UNKNOWN;
+        }
+        rect whole = {0, 0, target->width, target->height};
+        target->dirty_count = 0;
+        canvas_mark(target, whole);
+    }
+}
+
+long canvas_present(canvas *target, FILE *out) {
+    static present_buffer buffer;
+    buffer.out = out;
+    buffer.len = 0;
+    buffer.total = 0;
+
+    fit_cell_width(target);
+
+    for (int d = 0; d < target->dirty_count; d++) {
+        rect area = target->dirty[d];
+        for (int row = area.y; row < area.y + area.height; row++) {
+            const int *cells = target->cells[row];
+            int *shown = target->shown[row];
+            int j = area.x, end = area.x + area.width;
+            while (j < end) {
+                if (cells[j] == shown[j]) {
+                    j++;
+                    continue;
+                }
+                int start = j, last = j;
+                for (j++; j < end && j - last <= RUN_GAP; j++) {
+                    if (cells[j] != shown[j]) {
+                        last = j;
+                    }
+                }
+                present_run(&buffer, cells, row, start, last + 1, target->cell_width);
+                memcpy(shown + start, cells + start, (last + 1 - start) * sizeof(int));
+                j = last + 1;
+            }
+        }
+    }
+    target->dirty_count = 0;
+
+    buffer_flush(&buffer);
+    fflush(out);
+    return buffer.total;
+}
+
+void canvas_print(const canvas *target, FILE *out) {
+    for (int i = 0; i < target->height; i++) {
+        for (int j = 0; j < target->width; j++) {
+            fprintf(out, "%d", target->cells[i][j]);
+            if (j < target->width - 1) {
+                fputc(' ', out);
+            }
+        }
+        if (i < target->height - 1) {
+            fputc('\n', out);
+        }
+    }
+}
+
+int scene_init(scene *world, canvas *target) {
+    world->target = target;
+    world->count = 0;
+    world->capacity = 8;
+    world->items = (scene_item *)malloc(world->capacity * sizeof(scene_item));
+    world->order = (int *)malloc(world->capacity * sizeof(int));
+    if (world->items == NULL || world->order == NULL) {
+        scene_free(world);
+        return 0;
+    }
+    return 1;
+}
+
+void scene_free(scene *world) {
+    free(world->items);
+    free(world->order);
+    world->items = NULL;
+    world->order = NULL;
+    world->count = 0;
+    world->capacity = 0;
+}
+
+void mark_item(scene *world, int id) {
+    const scene_item *item = &world->items[id];
+    rect area = {item->x, item->y, item->image->width, item->image->height};
+    canvas_mark(world->target, area);
+}
+
+int scene_add(scene *world, const sprite *image, int x, int y, int layer) {
+    if (world->count == world->capacity) {
+        int capacity = world->capacity * 2;
+        scene_item *items = (scene_item *)realloc(world->items, capacity * sizeof(scene_item));
+        if (items == NULL) {
+            return -1;
+        }
+        world->items = items;
+        int *order = (int *)realloc(world->order, capacity * sizeof(int));
+        if (order == NULL) {
+            return -1;
+        }
+        world->order = order;
+        world->capacity = capacity;
+    }
+
+    int id = world->count++;
+    scene_item item = {image, x, y, layer};
+    world->items[id] = item;
+
+    int position = id;
+    while (position > 0 && world->items[world->order[position - 1]].layer > layer) {
+        world->order[position] = world->order[position - 1];
+        position--;
+    }
+    world->order[position] = id;
+    mark_item(world, id);
+    return id;
+}
+
+void scene_move(scene *world, int id, int x, int y) {
+    scene_item *item = &world->items[id];
+    if (item->x != x || item->y != y) {
+        mark_item(world, id);
+        item->x = x;
+        item->y = y;
+        mark_item(world, id);
+    }
+}
+
+void scene_set_sprite(scene *world, int id, const sprite *image) {
+    if (world->items[id].image != image) {
+        mark_item(world, id);
+        world->items[id].image = image;
+        mark_item(world, id);
+    }
+}
+
+void scene_compose(scene *world) {
+    canvas *target = world->target;
+    for (int d = 0; d < target->dirty_count; d++) {
+        rect area = target->dirty[d];
+        for (int row = area.y; row < area.y + area.height; row++) {
+            int *cells = target->cells[row];
+            for (int j = area.x; j < area.x + area.width; j++) {
+                cells[j] = target->background;
+            }
+        }
+        for (int i = 0; i < world->count; i++) {
+            const scene_item *item = &world->items[world->order[i]];
+            blit_clipped(target, item->image, item->x, item->y, area);
+        }
+    }
+}
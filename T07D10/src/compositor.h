@@ -0,0 +1,116 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <limits.h>
+#include <stdio.h>
+
+#define SPRITE_OPAQUE INT_MIN
+#define CANVAS_MAX_DIRTY 32
+#define CANVAS_CELL_WIDTH 2
+
+/*
+    A sprite is a contiguous row-major width x height block of cell values.
+    Cells equal to transparent are skipped when blitting; SPRITE_OPAQUE means
+    every cell is drawn.
+*/
+typedef struct sprite {
+    int width;
+    int height;
+    int transparent;
+    const int *pixels;
+} sprite;
+
+typedef struct rect {
+    int x;
+    int y;
+    int width;
+    int height;
+} rect;
+
+/*
+    cells is the composed frame in the matrix_create layout, shown is what the
+    terminal displays after the last canvas_present. dirty lists the disjoint
+    areas changed since then. cell_width is the number of terminal columns per
+    cell, the widest value presented so far plus a separating space.
+*/
+typedef struct canvas {
+    int width;
+    int height;
+    int background;
+    int **cells;
+    int **shown;
+    int cell_width;
+    rect dirty[CANVAS_MAX_DIRTY];
+    int dirty_count;
+} canvas;
+
+typedef struct scene_item {
+    const sprite *image;
+    int x;
+    int y;
+    int layer;
+} scene_item;
+
+/*
+    Sprites placed on a canvas. Higher layers are drawn over lower ones, and
+    within a layer later items are drawn over earlier ones. order holds item
+    ids sorted by that rule.
+*/
+typedef struct scene {
+    canvas *target;
+    scene_item *items;
+    int *order;
+    int count;
+    int capacity;
+} scene;
+
+/*
+    output: 1 on success, 0 on bad size or allocation error. A new canvas is
+    filled with background and entirely dirty.
+*/
+int canvas_create(canvas *target, int width, int height, int background);
+void canvas_free(canvas *target);
+
+/*
+    Adds area (clipped to the canvas) to the dirty list, merging it with the
+    rectangles it overlaps.
+*/
+void canvas_mark(canvas *target, rect area);
+
+/*
+    Draws image with its top-left corner at (x, y), clipped to the canvas,
+    and marks the covered area dirty.
+*/
+void canvas_blit(canvas *target, const sprite *image, int x, int y);
+
+/*
+    Sends the cells of the dirty areas that differ from what is shown to out
+    as ANSI cursor moves and cell_width-wide values, then clears the dirty
+    list. A value too wide for cell_width widens the cells, and the whole
+    canvas is redrawn at the new width.
+    output: number of bytes written
+*/
+long canvas_present(canvas *target, FILE *out);
+
+/*
+    Whole canvas as space-separated rows, without a trailing newline.
+*/
+void canvas_print(const canvas *target, FILE *out);
+
+int scene_init(scene *world, canvas *target);
+void scene_free(scene *world);
+
+/*
+    output: id of the new item, or -1 on allocation error
+*/
+int scene_add(scene *world, const sprite *image, int x, int y, int layer);
+void scene_move(scene *world, int id, int x, int y);
+void scene_set_sprite(scene *world, int id, const sprite *image);
+
+/*
+    Redraws the dirty areas of the canvas from the background and the items
+    that intersect them. Cells outside the dirty areas are not touched.
+*/
+void scene_compose(scene *world);
+
+#endif
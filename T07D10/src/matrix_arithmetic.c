@@ -1,14 +1,233 @@
-int input(int **matrix, int *n, int *m);
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "matrix_ops.h"
+#include "thread_pool.h"
+
+int input(int ***matrix, int *n, int *m);
 void output(int **matrix, int n, int m);
-int sum(int **matrix_first, int n_first, int m_first, int **matrix_second, 
-    int n_second, int m_second, int **matrix_result, int *n_result, int *m_result);
-int transpose(int **matrix, int n, int m);
-int mul(int **matrix_first, int n_first, int m_first, int **matrix_second, 
-    int n_second, int m_second, int **matrix_result, int *n_result, int *m_result);
+void output_wide(long long **matrix, int n, int m);
+int sum(int **matrix_first, int n_first, int m_first, int **matrix_second, int n_second, int m_second,
+        int **matrix_result, int *n_result, int *m_result);
+int transpose(int **matrix, int n, int m, int **matrix_result);
+int mul(int **matrix_first, int n_first, int m_first, int **matrix_second, int n_second, int m_second,
+        int **matrix_result, int *n_result, int *m_result);
+int mul_wide(int **matrix_first, int n_first, int m_first, int **matrix_second, int n_second, int m_second,
+             long long **matrix_result, int *n_result, int *m_result);
+int mul_fast(int **matrix_first, int n_first, int m_first, int **matrix_second, int n_second, int m_second,
+             int **matrix_result, int *n_result, int *m_result);
+
+int input(int ***matrix, int *n, int *m) {
+    if (scanf("%d %d", n, m) != 2) {
+        return 0;
+    }
+    if (*n <= 0 || *m <= 0) {
+        return 0;
+    }
+
+    *matrix = matrix_create(*n, *m);
+    if (*matrix == NULL) {
+        return 0;
+    }
+
+    for (int i = 0; i < *n; i++) {
+        for (int j = 0; j < *m; j++) {
+            if (scanf("%d", &(*matrix)[i][j]) != 1) {
+                free(*matrix);
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+void output(int **matrix, int n, int m) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            printf("%d", matrix[i][j]);
+            if (j < m - 1) {
+                printf(" ");
+            }
+        }
+        if (i < n - 1) {
+            printf("\n");
+        }
+    }
+}
 
-int main()
-{
-    
+void output_wide(long long **matrix, int n, int m) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            printf("%lld", matrix[i][j]);
+            if (j < m - 1) {
+                printf(" ");
+            }
+        }
+        if (i < n - 1) {
+            printf("\n");
+        }
+    }
 }
 
+int sum(int **matrix_first, int n_first, int m_first, int **matrix_second, int n_second, int m_second,
+        int **matrix_result, int *n_result, int *m_result) {
+    if (n_first != n_second || m_first != m_second) {
+        return 0;
+    }
+    matrix_sum_parallel(matrix_first, matrix_second, matrix_result, n_first, m_first);
+    *n_result = n_first;
+    *m_result = m_first;
+    return 1;
+}
+
+int transpose(int **matrix, int n, int m, int **matrix_result) {
+    if (n == m) {
+        matrix_transpose_square_parallel(matrix, n);
+        for (int i = 0; i < n; i++) {
+            memcpy(matrix_result[i], matrix[i], n * sizeof(int));
+        }
+    } else {
+        matrix_transpose_parallel(matrix, n, m, matrix_result);
+    }
+    return 1;
+}
+
+int mul(int **matrix_first, int n_first, int m_first, int **matrix_second, int n_second, int m_second,
+        int **matrix_result, int *n_result, int *m_result) {
+    if (m_first != n_second) {
+        return 0;
+    }
+    matrix_mul_parallel(matrix_first, matrix_second, matrix_result, n_first, m_first, m_second);
+    *n_result = n_first;
+    *m_result = m_second;
+    return 1;
+}
+
+int mul_wide(int **matrix_first, int n_first, int m_first, int **matrix_second, int n_second, int m_second,
+             long long **matrix_result, int *n_result, int *m_result) {
+    if (m_first != n_second) {
+        return 0;
+    }
+    matrix_mul_wide(matrix_first, matrix_second, matrix_result, n_first, m_first, m_second);
+    *n_result = n_first;
+    *m_result = m_second;
+    return 1;
+}
 
+int mul_fast(int **matrix_first, int n_first, int m_first, int **matrix_second, int n_second, int m_second,
+             int **matrix_result, int *n_result, int *m_result) {
+    if (m_first != n_second) {
+        return 0;
+    }
+    *n_result = n_first;
+    *m_result = m_second;
+    return matrix_mul_strassen(matrix_first, matrix_second, matrix_result, n_first, m_first, m_second);
+}
+
+int run_binary(int operation, int wide, int fast) {
+    int **first, **second;
+    int n_first, m_first, n_second, m_second, n_result, m_result;
+
+    if (!input(&first, &n_first, &m_first)) {
+        return 0;
+    }
+    if (!input(&second, &n_second, &m_second)) {
+        free(first);
+        return 0;
+    }
+
+    int result = 0;
+    if (operation == 1) {
+        int **matrix_result = matrix_create(n_first, m_first);
+        result = matrix_result != NULL && sum(first, n_first, m_first, second, n_second, m_second,
+                                              matrix_result, &n_result, &m_result);
+        if (result) {
+            output(matrix_result, n_result, m_result);
+        }
+        free(matrix_result);
+    } else if (wide) {
+        long long **matrix_result = matrix_create_wide(n_first, m_second);
+        result = matrix_result != NULL && mul_wide(first, n_first, m_first, second, n_second, m_second,
+                                                   matrix_result, &n_result, &m_result);
+        if (result) {
+            output_wide(matrix_result, n_result, m_result);
+        }
+        free(matrix_result);
+    } else {
+        int **matrix_result = matrix_create(n_first, m_second);
+        result = matrix_result != NULL && (fast ? mul_fast : mul)(first, n_first, m_first, second, n_second,
+                                                                  m_second, matrix_result, &n_result, &m_result);
+        if (result) {
+            output(matrix_result, n_result, m_result);
+        }
+        free(matrix_result);
+    }
+
+    free(first);
+    free(second);
+    return result;
+}
+
+int run_transpose(void) {
+    int **matrix;
+    int n, m;
+
+    if (!input(&matrix, &n, &m)) {
+        return 0;
+    }
+
+    int **matrix_result = matrix_create(m, n);
+    int result = matrix_result != NULL && transpose(matrix, n, m, matrix_result);
+    if (result) {
+        output(matrix_result, m, n);
+    }
+
+    free(matrix);
+    free(matrix_result);
+    return result;
+}
+
+/*
+    matrix_arithmetic [--wide | --strassen] [--threads N]
+    Reads the operation code (1 - sum, 2 - mul, 3 - transpose) and then the
+    matrices. --wide accumulates products in 64 bits and prints them untruncated,
+    --strassen multiplies with Strassen-Winograd above STRASSEN_CROSSOVER.
+    --threads N runs sum, transpose and mul on a pool of N threads; the
+    output is the same for any N.
+*/
+int main(int argc, char **argv) {
+    int operation;
+    int wide = 0, fast = 0, threads = 1;
+    int result = 1;
+
+    for (int i = 1; i < argc && result; i++) {
+        if (strcmp(argv[i], "--wide") == 0) {
+            wide = 1;
+        } else if (strcmp(argv[i], "--strassen") == 0) {
+            fast = 1;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            result = threads > 0;
+        }
+    }
+    result = result && thread_pool_init(threads);
+
+    if (result && scanf("%d", &operation) == 1) {
+        if (operation == 1 || operation == 2) {
+            result = run_binary(operation, wide, fast);
+        } else if (operation == 3) {
+            result = run_transpose();
+        } else {
+            result = 0;
+        }
+    } else {
+        result = 0;
+    }
+    thread_pool_shutdown();
+
+    if (!result) {
+        printf("n/a");
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "matrix_ops.h"
+#include "thread_pool.h"
+
+#define BENCH_SIZES 3
+#define SCALING_STEPS 4
+
+double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void fill_random(int **matrix, int n, int m) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            matrix[i][j] = rand() % 201 - 100;
+        }
+    }
+}
+
+void naive_mul(int **first, int **second, int **result, int n, int k, int m) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            int value = 0;
+            for (int p = 0; p < k; p++) {
+                value += first[i][p] * second[p][j];
+            }
+            result[i][j] = value;
+        }
+    }
+}
+
+void naive_transpose(int **matrix, int n, int m, int **result) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            result[j][i] = matrix[i][j];
+        }
+    }
+}
+
+int same(int **first, int **second, int n, int m) {
+    int result = 1;
+    for (int i = 0; i < n && result; i++) {
+        result = memcmp(first[i], second[i], m * sizeof(int)) == 0;
+    }
+    return result;
+}
+
+void bench_size(int n) {
+    int **a = matrix_create(n, n), **b = matrix_create(n, n);
+    int **expected = matrix_create(n, n), **actual = matrix_create(n, n);
+    long long **wide = matrix_create_wide(n, n);
+    fill_random(a, n, n);
+    fill_random(b, n, n);
+    double ops = 2.0 * n * n * n;
+
+    double start = now_seconds();
+    naive_mul(a, b, expected, n, n, n);
+    double naive = now_seconds() - start;
+
+    start = now_seconds();
+    matrix_mul(a, b, actual, n, n, n);
+    double tiled = now_seconds() - start;
+
+    start = now_seconds();
+    matrix_mul_wide(a, b, wide, n, n, n);
+    double tiled_wide = now_seconds() - start;
+
+    printf("mul %5d: naive %6.2f GOP/s, tiled %6.2f GOP/s, tiled 64-bit %6.2f GOP/s [%s]\n", n,
+           ops / naive * 1e-9, ops / tiled * 1e-9, ops / tiled_wide * 1e-9,
+           same(expected, actual, n, n) ? "ok" : "MISMATCH");
+
+    start = now_seconds();
+    matrix_mul_strassen(a, b, actual, n, n, n);
+    double strassen = now_seconds() - start;
+    printf("mul %5d: strassen-winograd %6.2f effective GOP/s [%s]\n", n, ops / strassen * 1e-9,
+           same(expected, actual, n, n) ? "ok" : "MISMATCH");
+
+    start = now_seconds();
+    naive_transpose(a, n, n, expected);
+    naive = now_seconds() - start;
+    start = now_seconds();
+    matrix_transpose_square(a, n);
+    tiled = now_seconds() - start;
+    printf("transpose %5d: naive %6.2f GB/s, blocked in place %6.2f GB/s [%s]\n", n,
+           2.0 * n * n * sizeof(int) / naive * 1e-9, 2.0 * n * n * sizeof(int) / tiled * 1e-9,
+           same(expected, a, n, n) ? "ok" : "MISMATCH");
+
+    free(a);
+    free(b);
+    free(expected);
+    free(actual);
+    free(wide);
+}
+
+void check_strassen_shape(int n, int k, int m) {
+    int **a = matrix_create(n, k), **b = matrix_create(k, m);
+    int **expected = matrix_create(n, m), **actual = matrix_create(n, m);
+    fill_random(a, n, k);
+    fill_random(b, k, m);
+    matrix_mul(a, b, expected, n, k, m);
+    matrix_mul_strassen(a, b, actual, n, k, m);
+    printf("strassen %dx%d * %dx%d [%s]\n", n, k, k, m, same(expected, actual, n, m) ? "ok" : "MISMATCH");
+    free(a);
+    free(b);
+    free(expected);
+    free(actual);
+}
+
+/*
+    Scaling curve of the pooled kernels: time per call and speedup over one
+    thread, with every result compared against the serial kernels.
+*/
+void bench_scaling(int n) {
+    int threads[SCALING_STEPS] = {1, 2, 4, 8};
+    int **a = matrix_create(n, n), **b = matrix_create(n, n);
+    int **expected = matrix_create(n, n), **actual = matrix_create(n, n);
+    int **sum_expected = matrix_create(n, n), **transposed = matrix_create(n, n);
+    fill_random(a, n, n);
+    fill_random(b, n, n);
+    matrix_mul(a, b, expected, n, n, n);
+    matrix_sum(a, b, sum_expected, n, n);
+    matrix_transpose(a, n, n, transposed);
+
+    double base_mul = 0, base_sum = 0, base_transpose = 0;
+    for (int i = 0; i < SCALING_STEPS; i++) {
+        thread_pool_init(threads[i]);
+
+        double start = now_seconds();
+        matrix_mul_parallel(a, b, actual, n, n, n);
+        double mul = now_seconds() - start;
+        int ok = same(expected, actual, n, n);
+
+        start = now_seconds();
+        matrix_sum_parallel(a, b, actual, n, n);
+        double sum = now_seconds() - start;
+        ok = ok && same(sum_expected, actual, n, n);
+
+        start = now_seconds();
+        matrix_transpose_parallel(a, n, n, actual);
+        matrix_transpose_square_parallel(a, n);
+        double transpose = now_seconds() - start;
+        ok = ok && same(transposed, actual, n, n) && same(transposed, a, n, n);
+        matrix_transpose_square_parallel(a, n);
+
+        if (i == 0) {
+            base_mul = mul;
+            base_sum = sum;
+            base_transpose = transpose;
+        }
+        printf("threads %d, n %d: mul %7.2f ms (x%.2f), sum %6.2f ms (x%.2f), transpose %6.2f ms (x%.2f) [%s]\n",
+               threads[i], n, mul * 1e3, base_mul / mul, sum * 1e3, base_sum / sum, transpose * 1e3,
+               base_transpose / transpose, ok ? "ok" : "MISMATCH");
+    }
+    thread_pool_shutdown();
+
+    free(a);
+    free(b);
+    free(expected);
+    free(actual);
+    free(sum_expected);
+    free(transposed);
+}
+
+int main(void) {
+    int sizes[BENCH_SIZES] = {256, 512, 1024};
+    srand(21);
+
+    printf("tuned crossover: STRASSEN_CROSSOVER=%d\n", matrix_tune_crossover(1024));
+    check_strassen_shape(777, 513, 1001);
+    check_strassen_shape(1023, 1025, 999);
+    for (int i = 0; i < BENCH_SIZES; i++) {
+        bench_size(sizes[i]);
+    }
+    for (int i = 0; i < BENCH_SIZES; i++) {
+        bench_scaling(sizes[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include "matrix_ops.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define ALIGNMENT 64
+
+void *allocate_rows(int n, int m, size_t element_size, char **data) {
+    size_t pointers = ((size_t)n * sizeof(void *) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    size_t size = (pointers + (size_t)n * m * element_size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    char *block = (char *)aligned_alloc(ALIGNMENT, size);
+    if (block != NULL) {
+        *data = block + pointers;
+    }
+    return block;
+}
+
+int **matrix_create(int n, int m) {
+    char *data;
+    int **matrix = (int **)allocate_rows(n, m, sizeof(int), &data);
+    if (matrix != NULL) {
+        for (int i = 0; i < n; i++) {
+            matrix[i] = (int *)data + (size_t)i * m;
+        }
+    }
+    return matrix;
+}
+
+long long **matrix_create_wide(int n, int m) {
+    char *data;
+    long long **matrix = (long long **)allocate_rows(n, m, sizeof(long long), &data);
+    if (matrix != NULL) {
+        for (int i = 0; i < n; i++) {
+            matrix[i] = (long long *)data + (size_t)i * m;
+        }
+    }
+    return matrix;
+}
+
+void matrix_sum(int **first, int **second, int **result, int n, int m) {
+    const int *a = first[0];
+    const int *b = second[0];
+    int *c = result[0];
+    size_t count = (size_t)n * m;
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8) {
+        __m256i sum = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(a + i)),
+                                       _mm256_loadu_si256((const __m256i *)(b + i)));
+        _mm256_storeu_si256((__m256i *)(c + i), sum);
+    }
+#elif defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        __m128i sum =
+            _mm_add_epi32(_mm_loadu_si128((const __m128i *)(a + i)), _mm_loadu_si128((const __m128i *)(b + i)));
+        _mm_storeu_si128((__m128i *)(c + i), sum);
+    }
+#endif
+    for (; i < count; i++) {
+        c[i] = (int)((unsigned int)a[i] + (unsigned int)b[i]);
+    }
+}
+
+void swap_tiles(int **matrix, int row, int col, int rows, int cols) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            int temp = matrix[row + i][col + j];
+            matrix[row + i][col + j] = matrix[col + j][row + i];
+            matrix[col + j][row + i] = temp;
+        }
+    }
+}
+
+void matrix_transpose_square(int **matrix, int n) {
+    for (int row = 0; row < n; row += TRANSPOSE_TILE) {
+        int rows = (n - row < TRANSPOSE_TILE) ? n - row : TRANSPOSE_TILE;
+        for (int i = 1; i < rows; i++) {
+            for (int j = 0; j < i; j++) {
+                int temp = matrix[row + i][row + j];
+                matrix[row + i][row + j] = matrix[row + j][row + i];
+                matrix[row + j][row + i] = temp;
+            }
+        }
+        for (int col = row + TRANSPOSE_TILE; col < n; col += TRANSPOSE_TILE) {
+            int cols = (n - col < TRANSPOSE_TILE) ? n - col : TRANSPOSE_TILE;
+            swap_tiles(matrix, row, col, rows, cols);
+        }
+    }
+}
+
+void matrix_transpose(int **matrix, int n, int m, int **result) {
+    for (int row = 0; row < n; row += TRANSPOSE_TILE) {
+        int row_end = (row + TRANSPOSE_TILE < n) ? row + TRANSPOSE_TILE : n;
+        for (int col = 0; col < m; col += TRANSPOSE_TILE) {
+            int col_end = (col + TRANSPOSE_TILE < m) ? col + TRANSPOSE_TILE : m;
+            for (int i = row; i < row_end; i++) {
+                for (int j = col; j < col_end; j++) {
+                    result[j][i] = matrix[i][j];
+                }
+            }
+        }
+    }
+}
+
+/*
+    Leaf kernels in i-p-j order: the innermost loop runs along contiguous
+    rows of second and result, so it vectorizes. Arithmetic is unsigned so
+    32-bit overflow wraps instead of being undefined.
+*/
+void mul_leaf(const int *first, int first_stride, const int *second, int second_stride, int *result,
+              int result_stride, int rows, int depths, int cols) {
+    for (int i = 0; i < rows; i++) {
+        unsigned int *target = (unsigned int *)result + (size_t)i * result_stride;
+        const int *factors = first + (size_t)i * first_stride;
+        for (int p = 0; p < depths; p++) {
+            unsigned int factor = (unsigned int)factors[p];
+            const unsigned int *source = (const unsigned int *)second + (size_t)p * second_stride;
+            for (int j = 0; j < cols; j++) {
+                target[j] += factor * source[j];
+            }
+        }
+    }
+}
+
+void mul_leaf_wide(const int *first, int first_stride, const int *second, int second_stride,
+                   long long *result, int result_stride, int rows, int depths, int cols) {
+    for (int i = 0; i < rows; i++) {
+        long long *target = result + (size_t)i * result_stride;
+        const int *factors = first + (size_t)i * first_stride;
+        for (int p = 0; p < depths; p++) {
+            long long factor = factors[p];
+            const int *source = second + (size_t)p * second_stride;
+            for (int j = 0; j < cols; j++) {
+                target[j] += factor * source[j];
+            }
+        }
+    }
+}
+
+void matrix_mul_block(const int *first, int first_stride, const int *second, int second_stride, int *result,
+                      int result_stride, int n, int k, int m) {
+    if ((long long)n * k * m <= MUL_LEAF_VOLUME || (n < 2 && k < 2 && m < 2)) {
+        mul_leaf(first, first_stride, second, second_stride, result, result_stride, n, k, m);
+    } else if (n >= m && n >= k) {
+        int half = n / 2;
+        matrix_mul_block(first, first_stride, second, second_stride, result, result_stride, half, k, m);
+        matrix_mul_block(first + (size_t)half * first_stride, first_stride, second, second_stride,
+                         result + (size_t)half * result_stride, result_stride, n - half, k, m);
+    } else if (m >= k) {
+        int half = m / 2;
+        matrix_mul_block(first, first_stride, second, second_stride, result, result_stride, n, k, half);
+        matrix_mul_block(first, first_stride, second + half, second_stride, result + half, result_stride, n, k,
+                         m - half);
+    } else {
+        int half = k / 2;
+        matrix_mul_block(first, first_stride, second, second_stride, result, result_stride, n, half, m);
+        matrix_mul_block(first + half, first_stride, second + (size_t)half * second_stride, second_stride,
+                         result, result_stride, n, k - half, m);
+    }
+}
+
+void mul_block_wide(const int *first, int first_stride, const int *second, int second_stride, long long *result,
+                    int result_stride, int n, int k, int m) {
+    if ((long long)n * k * m <= MUL_LEAF_VOLUME || (n < 2 && k < 2 && m < 2)) {
+        mul_leaf_wide(first, first_stride, second, second_stride, result, result_stride, n, k, m);
+    } else if (n >= m && n >= k) {
+        int half = n / 2;
+        mul_block_wide(first, first_stride, second, second_stride, result, result_stride, half, k, m);
+        mul_block_wide(first + (size_t)half * first_stride, first_stride, second, second_stride,
+                       result + (size_t)half * result_stride, result_stride, n - half, k, m);
+    } else if (m >= k) {
+        int half = m / 2;
+        mul_block_wide(first, first_stride, second, second_stride, result, result_stride, n, k, half);
+        mul_block_wide(first, first_stride, second + half, second_stride, result + half, result_stride, n, k,
+                       m - half);
+    } else {
+        int half = k / 2;
+        mul_block_wide(first, first_stride, second, second_stride, result, result_stride, n, half, m);
+        mul_block_wide(first + half, first_stride, second + (size_t)half * second_stride, second_stride, result,
+                       result_stride, n, k - half, m);
+    }
+}
+
+void matrix_mul(int **first, int **second, int **result, int n, int k, int m) {
+    memset(result[0], 0, (size_t)n * m * sizeof(int));
+    matrix_mul_block(first[0], k, second[0], m, result[0], m, n, k, m);
+}
+
+void matrix_mul_wide(int **first, int **second, long long **result, int n, int k, int m) {
+    memset(result[0], 0, (size_t)n * m * sizeof(long long));
+    mul_block_wide(first[0], k, second[0], m, result[0], m, n, k, m);
+}
@@ -0,0 +1,80 @@
+#ifndef MATRIX_OPS_H
+#define MATRIX_OPS_H
+
+#define TRANSPOSE_TILE 32
+#define MUL_LEAF_VOLUME (64 * 64 * 64)
+
+#define PARALLEL_TILE 128
+#define PARALLEL_MIN_ELEMENTS (1 << 16)
+#define PARALLEL_MIN_VOLUME (128 * 128 * 128)
+
+#ifndef STRASSEN_CROSSOVER
+#define STRASSEN_CROSSOVER 64
+#endif
+
+/*
+    Matrices are row-pointer arrays over one contiguous row-major block, the
+    same layout transform() builds in picture.c. matrix_create returns a single
+    allocation (pointers followed by data) that is released with free().
+*/
+int **matrix_create(int n, int m);
+long long **matrix_create_wide(int n, int m);
+
+/*
+    result = first + second, elementwise over the contiguous block.
+    Wraps around on int overflow.
+*/
+void matrix_sum(int **first, int **second, int **result, int n, int m);
+
+/*
+    Blocked transposes: in place for square matrices, into an m x n result
+    for rectangular ones.
+*/
+void matrix_transpose_square(int **matrix, int n);
+void matrix_transpose(int **matrix, int n, int m, int **result);
+
+/*
+    result (n x m) = first (n x k) * second (k x m), by cache-oblivious
+    recursive splitting of the largest dimension down to MUL_LEAF_VOLUME.
+    matrix_mul accumulates in 32 bits and wraps around on overflow,
+    matrix_mul_wide accumulates exactly in 64 bits.
+*/
+void matrix_mul(int **first, int **second, int **result, int n, int k, int m);
+void matrix_mul_wide(int **first, int **second, long long **result, int n, int k, int m);
+
+/*
+    result += first * second on strided row-major blocks: row i of first
+    starts at first + i * first_stride, and likewise for the others.
+*/
+void matrix_mul_block(const int *first, int first_stride, const int *second, int second_stride, int *result,
+                      int result_stride, int n, int k, int m);
+
+/*
+    Same contracts as the serial versions, split by output tile across the
+    threads of thread_pool_init(). Below PARALLEL_MIN_ELEMENTS (sum,
+    transpose) or PARALLEL_MIN_VOLUME (mul) they run serially. Every output
+    element is computed by one thread in a fixed order, so results do not
+    depend on the thread count.
+*/
+void matrix_sum_parallel(int **first, int **second, int **result, int n, int m);
+void matrix_transpose_square_parallel(int **matrix, int n);
+void matrix_transpose_parallel(int **matrix, int n, int m, int **result);
+void matrix_mul_parallel(int **first, int **second, int **result, int n, int k, int m);
+
+/*
+    Strassen-Winograd multiplication, same contract as matrix_mul. Recursion
+    stops once any dimension is at most strassen_crossover; temporaries
+    come from one arena allocated up front.
+    output: 0 if the arena could not be allocated
+*/
+extern int strassen_crossover;
+int matrix_mul_strassen(int **first, int **second, int **result, int n, int k, int m);
+
+/*
+    Times matrix_mul against Strassen with several crossovers on a random
+    n x n product, stores the fastest in strassen_crossover and returns it
+    (n when the classical kernel wins outright).
+*/
+int matrix_tune_crossover(int n);
+
+#endif
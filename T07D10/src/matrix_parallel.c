@@ -0,0 +1,120 @@
+#include <string.h>
+
+#include "matrix_ops.h"
+#include "thread_pool.h"
+
+typedef struct parallel_job {
+    int **first;
+    int **second;
+    int **result;
+    int n;
+    int k;
+    int m;
+    int tiles_per_row;
+} parallel_job;
+
+int tile_count(int size, int tile) { return (size + tile - 1) / tile; }
+
+int tile_size(int size, int start, int tile) { return (size - start < tile) ? size - start : tile; }
+
+void sum_task(void *arg, int index) {
+    const parallel_job *job = (const parallel_job *)arg;
+    int row = index * PARALLEL_TILE;
+    matrix_sum(job->first + row, job->second + row, job->result + row, tile_size(job->n, row, PARALLEL_TILE),
+               job->m);
+}
+
+void matrix_sum_parallel(int **first, int **second, int **result, int n, int m) {
+    if ((long long)n * m < PARALLEL_MIN_ELEMENTS || thread_pool_threads() == 1) {
+        matrix_sum(first, second, result, n, m);
+    } else {
+        parallel_job job = {first, second, result, n, 0, m, 0};
+        thread_pool_run(sum_task, &job, tile_count(n, PARALLEL_TILE));
+    }
+}
+
+void transpose_square_task(void *arg, int index) {
+    const parallel_job *job = (const parallel_job *)arg;
+    int **matrix = job->first;
+    int row = index * TRANSPOSE_TILE;
+    int rows = tile_size(job->n, row, TRANSPOSE_TILE);
+
+    for (int i = 1; i < rows; i++) {
+        for (int j = 0; j < i; j++) {
+            int temp = matrix[row + i][row + j];
+            matrix[row + i][row + j] = matrix[row + j][row + i];
+            matrix[row + j][row + i] = temp;
+        }
+    }
+    for (int col = row + TRANSPOSE_TILE; col < job->n; col += TRANSPOSE_TILE) {
+        int cols = tile_size(job->n, col, TRANSPOSE_TILE);
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                int temp = matrix[row + i][col + j];
+                matrix[row + i][col + j] = matrix[col + j][row + i];
+                matrix[col + j][row + i] = temp;
+            }
+        }
+    }
+}
+
+void matrix_transpose_square_parallel(int **matrix, int n) {
+    if ((long long)n * n < PARALLEL_MIN_ELEMENTS || thread_pool_threads() == 1) {
+        matrix_transpose_square(matrix, n);
+    } else {
+        parallel_job job = {matrix, NULL, NULL, n, 0, n, 0};
+        thread_pool_run(transpose_square_task, &job, tile_count(n, TRANSPOSE_TILE));
+    }
+}
+
+void transpose_task(void *arg, int index) {
+    const parallel_job *job = (const parallel_job *)arg;
+    int row = index * TRANSPOSE_TILE;
+    int row_end = row + tile_size(job->n, row, TRANSPOSE_TILE);
+
+    for (int col = 0; col < job->m; col += TRANSPOSE_TILE) {
+        int col_end = col + tile_size(job->m, col, TRANSPOSE_TILE);
+        for (int i = row; i < row_end; i++) {
+            for (int j = col; j < col_end; j++) {
+                job->result[j][i] = job->first[i][j];
+            }
+        }
+    }
+}
+
+void matrix_transpose_parallel(int **matrix, int n, int m, int **result) {
+    if ((long long)n * m < PARALLEL_MIN_ELEMENTS || thread_pool_threads() == 1) {
+        matrix_transpose(matrix, n, m, result);
+    } else {
+        parallel_job job = {matrix, NULL, result, n, 0, m, 0};
+        thread_pool_run(transpose_task, &job, tile_count(n, TRANSPOSE_TILE));
+    }
+}
+
+/*
+    Each task owns one PARALLEL_TILE x PARALLEL_TILE tile of the result and
+    runs the whole k loop for it, so every element is produced by exactly one
+    thread in the same order whatever the thread count.
+*/
+void mul_task(void *arg, int index) {
+    const parallel_job *job = (const parallel_job *)arg;
+    int row = index / job->tiles_per_row * PARALLEL_TILE;
+    int col = index % job->tiles_per_row * PARALLEL_TILE;
+    int rows = tile_size(job->n, row, PARALLEL_TILE);
+    int cols = tile_size(job->m, col, PARALLEL_TILE);
+
+    int *target = job->result[row] + col;
+    for (int i = 0; i < rows; i++) {
+        memset(target + (size_t)i * job->m, 0, cols * sizeof(int));
+    }
+    matrix_mul_block(job->first[row], job->k, job->second[0] + col, job->m, target, job->m, rows, job->k, cols);
+}
+
+void matrix_mul_parallel(int **first, int **second, int **result, int n, int k, int m) {
+    if ((long long)n * k * m < PARALLEL_MIN_VOLUME || thread_pool_threads() == 1) {
+        matrix_mul(first, second, result, n, k, m);
+    } else {
+        parallel_job job = {first, second, result, n, k, m, tile_count(m, PARALLEL_TILE)};
+        thread_pool_run(mul_task, &job, tile_count(n, PARALLEL_TILE) * job.tiles_per_row);
+    }
+}
@@ -1,57 +1,63 @@
-#define N 15
-#define M 13
-
-void transform(int *buf, int **matr, int n, int m);
-void make_picture(int **picture, int n, int m);
-void reset_picture(int **picture, int n, int m);
-
-void main()
-{
-   int picture_data[N][M];
-   int *picture[N];
-   transform(picture_data, picture, N, M);
+#include <stdio.h>
 
-   make_picture(picture, );
-}
+#include "compositor.h"
 
-void make_picture(int **picture, int n, int m)
-{
-   int frame_w[] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
-   int frame_h[] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
-   int tree_trunk[] = { 7, 7, 7, 7 };
-   int tree_foliage[] = { 3, 3, 3, 3 };
-   int sun_data[6][5] = { { 0, 6, 6, 6, 6 }, 
-                          { 0, 0, 6, 6, 6 }, 
-                          { 0, 0, 6, 6, 6 },
-                          { 0, 6, 0, 0, 6 },
-                          { 0, 0, 0, 0, 0 },
-                          { 0, 0, 0, 0, 0 } };
-
-   reset_picture(picture, n, m);
-
-   int length_frame_w = sizeof(frame_w) / sizeof(frame_w[0]);
-   
-   for (int i = 0; i < length_frame_w; i++)
-   {
-      picture[0][i] = frame_w[i];
-   }
-}
+#define N 15
+#define M 13
 
-void reset_picture(int **picture, int n, int m)
-{
-   for (int i = 0; i < m; i++)
-   {
-      for (int j = 0; j < n; j++)
-      {
-         picture[i][j] = 0;
-      }  
-   }
+enum picture_layer { LAYER_TREE, LAYER_SUN, LAYER_FRAME };
+
+int make_picture(scene *world);
+
+int main(void) {
+    canvas picture;
+    scene world;
+    int result = canvas_create(&picture, M, N, 0);
+
+    if (result) {
+        result = scene_init(&world, &picture);
+        if (result) {
+            result = make_picture(&world);
+            if (result) {
+                scene_compose(&world);
+                canvas_print(&picture, stdout);
+            }
+            scene_free(&world);
+        }
+        canvas_free(&picture);
+    }
+
+    if (!result) {
+        printf("n/a");
+    }
+    return 0;
 }
 
-void transform(int *buf, int **matr, int n, int m)
-{  
-   for(int i = 0; i < n; i++)
-   {
-      matr[i] = buf + i * m;
-   }
+/*
+    The frame is drawn from one horizontal and one vertical bar sprite on the
+    top layer, so the middle bar crosses the tree trunk.
+*/
+int make_picture(scene *world) {
+    static const int frame_w[] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+    static const int frame_h[] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+    static const int tree_trunk[] = {0, 7, 7, 0, 0, 7, 7, 0, 0, 7, 7, 0, 0, 7, 7, 0, 7, 7, 7, 7};
+    static const int tree_foliage[] = {0, 3, 3, 0, 3, 3, 3, 3, 3, 3, 3, 3, 0, 3, 3, 0};
+    static const int sun_data[] = {0, 6, 6, 6, 6, 0, 0, 6, 6, 6, 0, 0, 6, 6, 6,
+                                   0, 6, 0, 0, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    static const sprite frame_row = {M, 1, SPRITE_OPAQUE, frame_w};
+    static const sprite frame_column = {1, N, SPRITE_OPAQUE, frame_h};
+    static const sprite trunk = {4, 5, 0, tree_trunk};
+    static const sprite foliage = {4, 4, 0, tree_foliage};
+    static const sprite sun = {5, 6, 0, sun_data};
+
+    int result = scene_add(world, &foliage, 2, 2, LAYER_TREE) >= 0;
+    result = result && scene_add(world, &trunk, 2, 6, LAYER_TREE) >= 0;
+    result = result && scene_add(world, &sun, 7, 1, LAYER_SUN) >= 0;
+    for (int row = 0; row < N && result; row += N / 2) {
+        result = scene_add(world, &frame_row, 0, row, LAYER_FRAME) >= 0;
+    }
+    for (int col = 0; col < M && result; col += M / 2) {
+        result = scene_add(world, &frame_column, col, 0, LAYER_FRAME) >= 0;
+    }
+    return result;
 }
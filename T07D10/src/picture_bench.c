@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "compositor.h"
+
+#define BENCH_WIDTH 400
+#define BENCH_HEIGHT 120
+#define BENCH_SPRITES 64
+#define BENCH_FRAMES 500
+#define SPRITE_W 8
+#define SPRITE_H 6
+
+double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+    Both canvases run the same animation: one redraws and resends every cell
+    each frame, the other only its dirty rectangles. Their cells are compared
+    after every frame.
+*/
+int main(void) {
+    static int pixels[SPRITE_W * SPRITE_H];
+    for (int i = 0; i < SPRITE_W * SPRITE_H; i++) {
+        pixels[i] = (i % 5 == 0) ? 0 : 1 + i % 9;
+    }
+    sprite image = {SPRITE_W, SPRITE_H, 0, pixels};
+
+    canvas full, dirty;
+    scene full_world, dirty_world;
+    FILE *sink = fopen("/dev/null", "w");
+    if (sink == NULL || !canvas_create(&full, BENCH_WIDTH, BENCH_HEIGHT, 0) ||
+        !canvas_create(&dirty, BENCH_WIDTH, BENCH_HEIGHT, 0) || !scene_init(&full_world, &full) ||
+        !scene_init(&dirty_world, &dirty)) {
+        printf("n/a");
+        return 0;
+    }
+
+    int x[BENCH_SPRITES], y[BENCH_SPRITES], dx[BENCH_SPRITES], dy[BENCH_SPRITES];
+    srand(21);
+    for (int i = 0; i < BENCH_SPRITES; i++) {
+        x[i] = rand() % (BENCH_WIDTH - SPRITE_W);
+        y[i] = rand() % (BENCH_HEIGHT - SPRITE_H);
+        dx[i] = (i % 3 == 0) ? 0 : 1 - 2 * (rand() % 2);
+        dy[i] = (i % 4 == 0) ? 1 : 0;
+        scene_add(&full_world, &image, x[i], y[i], i % 3);
+        scene_add(&dirty_world, &image, x[i], y[i], i % 3);
+    }
+
+    double full_time = 0, dirty_time = 0;
+    long full_bytes = 0, dirty_bytes = 0;
+    int ok = 1;
+    rect whole = {0, 0, BENCH_WIDTH, BENCH_HEIGHT};
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        for (int i = 0; i < BENCH_SPRITES; i++) {
+            x[i] = (x[i] + dx[i] + BENCH_WIDTH) % BENCH_WIDTH;
+            y[i] = (y[i] + dy[i] + BENCH_HEIGHT) % BENCH_HEIGHT;
+        }
+
+        double start = now_seconds();
+        for (int i = 0; i < BENCH_SPRITES; i++) {
+            full_world.items[i].x = x[i];
+            full_world.items[i].y = y[i];
+        }
+        canvas_mark(&full, whole);
+        scene_compose(&full_world);
+        for (int i = 0; i < BENCH_HEIGHT; i++) {
+            memset(full.shown[i], 0x80, BENCH_WIDTH * sizeof(int));
+        }
+        full_bytes += canvas_present(&full, sink);
+        full_time += now_seconds() - start;
+
+        start = now_seconds();
+        for (int i = 0; i < BENCH_SPRITES; i++) {
+            scene_move(&dirty_world, i, x[i], y[i]);
+        }
+        scene_compose(&dirty_world);
+        dirty_bytes += canvas_present(&dirty, sink);
+        dirty_time += now_seconds() - start;
+
+        ok = ok && memcmp(full.cells[0], dirty.cells[0], sizeof(int) * BENCH_WIDTH * BENCH_HEIGHT) == 0;
+    }
+
+    printf("%dx%d canvas, %d sprites, %d frames [%s]\n", BENCH_WIDTH, BENCH_HEIGHT, BENCH_SPRITES,
+           BENCH_FRAMES, ok ? "ok" : "MISMATCH");
+    printf("full redraw:  %7.3f ms/frame, %8.1f KB/frame\n", full_time * 1e3 / BENCH_FRAMES,
+           full_bytes / 1024.0 / BENCH_FRAMES);
+    printf("dirty rects:  %7.3f ms/frame, %8.1f KB/frame\n", dirty_time * 1e3 / BENCH_FRAMES,
+           dirty_bytes / 1024.0 / BENCH_FRAMES);
+
+    scene_free(&full_world);
+    scene_free(&dirty_world);
+    canvas_free(&full);
+    canvas_free(&dirty);
+    fclose(sink);
+    return 0;
+}
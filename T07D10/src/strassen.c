@@ -0,0 +1,201 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "matrix_ops.h"
+
+#define TUNE_CANDIDATES 6
+#define TUNE_RUNS 3
+
+int strassen_crossover = STRASSEN_CROSSOVER;
+
+typedef struct block {
+    int *data;
+    int stride;
+} block;
+
+block sub_block(block matrix, int row, int col) {
+    block result = {matrix.data + (size_t)row * matrix.stride + col, matrix.stride};
+    return result;
+}
+
+void combine(block result, block first, block second, int sign, int rows, int cols) {
+    for (int i = 0; i < rows; i++) {
+        unsigned int *target = (unsigned int *)result.data + (size_t)i * result.stride;
+        const unsigned int *left = (const unsigned int *)first.data + (size_t)i * first.stride;
+        const unsigned int *right = (const unsigned int *)second.data + (size_t)i * second.stride;
+        if (sign > 0) {
+            for (int j = 0; j < cols; j++) {
+                target[j] = left[j] + right[j];
+            }
+        } else {
+            for (int j = 0; j < cols; j++) {
+                target[j] = left[j] - right[j];
+            }
+        }
+    }
+}
+
+void clear_block(block matrix, int rows, int cols) {
+    for (int i = 0; i < rows; i++) {
+        memset(matrix.data + (size_t)i * matrix.stride, 0, cols * sizeof(int));
+    }
+}
+
+void classical(block first, block second, block result, int n, int k, int m) {
+    clear_block(result, n, m);
+    matrix_mul_block(first.data, first.stride, second.data, second.stride, result.data, result.stride, n, k, m);
+}
+
+size_t arena_size(int n, int k, int m, int crossover) {
+    size_t size = 0;
+    while (n > crossover && k > crossover && m > crossover) {
+        n /= 2;
+        k /= 2;
+        m /= 2;
+        size += (size_t)n * k + (size_t)k * m + (size_t)n * m;
+    }
+    return size;
+}
+
+void strassen(block first, block second, block result, int n, int k, int m, int *arena, int crossover);
+
+/*
+    Winograd's variant (7 products, 15 additions) on the even-sized core,
+    in the Douglas et al. schedule: the quadrants of result double as
+    temporaries, so each level needs only X, Y and Z from the arena.
+*/
+void winograd_core(block a, block b, block c, int n2, int k2, int m2, int *arena, int crossover) {
+    block a11 = a, a12 = sub_block(a, 0, k2), a21 = sub_block(a, n2, 0), a22 = sub_block(a, n2, k2);
+    block b11 = b, b12 = sub_block(b, 0, m2), b21 = sub_block(b, k2, 0), b22 = sub_block(b, k2, m2);
+    block c11 = c, c12 = sub_block(c, 0, m2), c21 = sub_block(c, n2, 0), c22 = sub_block(c, n2, m2);
+    block x = {arena, k2};
+    block y = {x.data + (size_t)n2 * k2, m2};
+    block z = {y.data + (size_t)k2 * m2, m2};
+    int *next = z.data + (size_t)n2 * m2;
+
+    combine(x, a11, a21, -1, n2, k2);
+    combine(y, b22, b12, -1, k2, m2);
+    strassen(x, y, c21, n2, k2, m2, next, crossover);
+    combine(x, a21, a22, 1, n2, k2);
+    combine(y, b12, b11, -1, k2, m2);
+    strassen(x, y, c22, n2, k2, m2, next, crossover);
+    combine(x, x, a11, -1, n2, k2);
+    combine(y, b22, y, -1, k2, m2);
+    strassen(x, y, c12, n2, k2, m2, next, crossover);
+    combine(x, a12, x, -1, n2, k2);
+    strassen(x, b22, c11, n2, k2, m2, next, crossover);
+    strassen(a11, b11, z, n2, k2, m2, next, crossover);
+
+    combine(c12, z, c12, 1, n2, m2);
+    combine(c21, c12, c21, 1, n2, m2);
+    combine(c12, c12, c22, 1, n2, m2);
+    combine(c22, c21, c22, 1, n2, m2);
+    combine(c12, c12, c11, 1, n2, m2);
+    combine(y, y, b21, -1, k2, m2);
+    strassen(a22, y, c11, n2, k2, m2, next, crossover);
+    combine(c21, c21, c11, -1, n2, m2);
+    strassen(a12, b21, c11, n2, k2, m2, next, crossover);
+    combine(c11, c11, z, 1, n2, m2);
+}
+
+/*
+    result = first * second. Odd dimensions are peeled: the even core goes
+    through winograd_core and the last row, column or rank-1 term is fixed
+    up with the classical kernel.
+*/
+void strassen(block first, block second, block result, int n, int k, int m, int *arena, int crossover) {
+    if (n <= crossover || k <= crossover || m <= crossover) {
+        classical(first, second, result, n, k, m);
+        return;
+    }
+
+    int n_even = n & ~1, k_even = k & ~1, m_even = m & ~1;
+    winograd_core(first, second, result, n_even / 2, k_even / 2, m_even / 2, arena, crossover);
+
+    if (k != k_even) {
+        matrix_mul_block(first.data + k_even, first.stride, second.data + (size_t)k_even * second.stride,
+                         second.stride, result.data, result.stride, n_even, 1, m_even);
+    }
+    if (m != m_even) {
+        classical(first, sub_block(second, 0, m_even), sub_block(result, 0, m_even), n, k, 1);
+    }
+    if (n != n_even) {
+        classical(sub_block(first, n_even, 0), second, sub_block(result, n_even, 0), 1, k, m_even);
+    }
+}
+
+int strassen_with(int **first, int **second, int **result, int n, int k, int m, int crossover) {
+    int *arena = (int *)malloc((arena_size(n, k, m, crossover) + 1) * sizeof(int));
+    if (arena != NULL) {
+        block a = {first[0], k}, b = {second[0], m}, c = {result[0], m};
+        strassen(a, b, c, n, k, m, arena, crossover);
+        free(arena);
+    }
+    return arena != NULL;
+}
+
+int matrix_mul_strassen(int **first, int **second, int **result, int n, int k, int m) {
+    return strassen_with(first, second, result, n, k, m, strassen_crossover);
+}
+
+double elapsed_since(const struct timespec *start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/*
+    Best of TUNE_RUNS products after one untimed warm-up run, so page faults
+    and cold caches don't decide; crossover 0 times the classical kernel.
+    output: seconds, or a negative value if Strassen could not allocate
+*/
+double time_product(int **first, int **second, int **result, int n, int crossover) {
+    double best = -1;
+    for (int run = 0; run <= TUNE_RUNS; run++) {
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int done = 1;
+        if (crossover == 0) {
+            matrix_mul(first, second, result, n, n, n);
+        } else {
+            done = strassen_with(first, second, result, n, n, n, crossover);
+        }
+        double time = elapsed_since(&start);
+        if (!done) {
+            return -1;
+        }
+        if (run > 0 && (best < 0 || time < best)) {
+            best = time;
+        }
+    }
+    return best;
+}
+
+int matrix_tune_crossover(int n) {
+    int candidates[TUNE_CANDIDATES] = {32, 64, 128, 256, 512, 1024};
+    int **first = matrix_create(n, n), **second = matrix_create(n, n), **result = matrix_create(n, n);
+    int best = n;
+
+    if (first != NULL && second != NULL && result != NULL) {
+        for (size_t i = 0; i < (size_t)n * n; i++) {
+            first[0][i] = rand() % 201 - 100;
+            second[0][i] = rand() % 201 - 100;
+        }
+
+        double best_time = time_product(first, second, result, n, 0);
+        for (int i = 0; i < TUNE_CANDIDATES && candidates[i] < n; i++) {
+            double time = time_product(first, second, result, n, candidates[i]);
+            if (time >= 0 && time < best_time) {
+                best_time = time;
+                best = candidates[i];
+            }
+        }
+        strassen_crossover = best;
+    }
+
+    free(first);
+    free(second);
+    free(result);
+    return best;
+}
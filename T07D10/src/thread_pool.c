@@ -0,0 +1,127 @@
+#include "thread_pool.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+typedef struct thread_pool {
+    pthread_t *workers;
+    int count;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    pool_task task;
+    void *arg;
+    int total;
+    int next;
+    int active;
+    unsigned long generation;
+    unsigned long spawned;
+    int stop;
+} thread_pool;
+
+static thread_pool pool = {NULL, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+                           PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0, 0, 0, 0, 0};
+
+static void run_indices(pool_task task, void *arg, int total) {
+    int index = __atomic_fetch_add(&pool.next, 1, __ATOMIC_RELAXED);
+    while (index < total) {
+        task(arg, index);
+        index = __atomic_fetch_add(&pool.next, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void *worker_main(void *unused) {
+    (void)unused;
+    pthread_mutex_lock(&pool.lock);
+    unsigned long seen = pool.spawned;
+    while (1) {
+        while (!pool.stop && pool.generation == seen) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        }
+        if (pool.stop) {
+            break;
+        }
+        seen = pool.generation;
+        pool_task task = pool.task;
+        void *arg = pool.arg;
+        int total = pool.total;
+        pthread_mutex_unlock(&pool.lock);
+
+        run_indices(task, arg, total);
+
+        pthread_mutex_lock(&pool.lock);
+        if (--pool.active == 0) {
+            pthread_cond_signal(&pool.done);
+        }
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return NULL;
+}
+
+int thread_pool_init(int threads) {
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (pool.workers != NULL && pool.count == threads - 1) {
+        return 1;
+    }
+    thread_pool_shutdown();
+
+    pool.workers = (pthread_t *)malloc((threads > 1 ? threads - 1 : 1) * sizeof(pthread_t));
+    if (pool.workers == NULL) {
+        return 0;
+    }
+    pool.stop = 0;
+    pool.count = 0;
+    pool.spawned = pool.generation;
+    while (pool.count < threads - 1 && pthread_create(&pool.workers[pool.count], NULL, worker_main, NULL) == 0) {
+        pool.count++;
+    }
+    return pool.count == threads - 1;
+}
+
+int thread_pool_threads(void) { return pool.count + 1; }
+
+void thread_pool_run(pool_task task, void *arg, int count) {
+    if (pool.count == 0 || count < 2) {
+        for (int i = 0; i < count; i++) {
+            task(arg, i);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.task = task;
+    pool.arg = arg;
+    pool.total = count;
+    pool.next = 0;
+    pool.active = pool.count;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    run_indices(task, arg, count);
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.active > 0) {
+        pthread_cond_wait(&pool.done, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+}
+
+void thread_pool_shutdown(void) {
+    if (pool.workers == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&pool.lock);
+    pool.stop = 1;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (int i = 0; i < pool.count; i++) {
+        pthread_join(pool.workers[i], NULL);
+    }
+    free(pool.workers);
+    pool.workers = NULL;
+    pool.count = 0;
+}
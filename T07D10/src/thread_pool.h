@@ -0,0 +1,17 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/*
+    A process-wide pool of worker threads, created once and reused by every
+    parallel call. thread_pool_run(task, arg, count) calls task(arg, i) for
+    each i in [0, count) on the workers and the calling thread, and returns
+    once all of them are done. Not reentrant: tasks must not call it.
+*/
+typedef void (*pool_task)(void *arg, int index);
+
+int thread_pool_init(int threads);
+int thread_pool_threads(void);
+void thread_pool_run(pool_task task, void *arg, int count);
+void thread_pool_shutdown(void);
+
+#endif
@@ -1,8 +1,14 @@
+#include <float.h>
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "integer_det.h"
+#include "matrix_file.h"
+#include "matrix_io.h"
 
 double det(double **matrix, int n, int m);
+int log_det(double **matrix, int n, int *sign, double *log_abs);
 int input(double ***matrix, int *n, int *m);
 void output(double det);
 
@@ -103,8 +109,60 @@ double det(double **matrix, int n, int m) {
     return sign * determinant;
 }
 
+double max_abs_element(double **matrix, int n) {
+    double result = 0.0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (fabs(matrix[i][j]) > result) {
+                result = fabs(matrix[i][j]);
+            }
+        }
+    }
+    return result;
+}
+
+/*
+    Same elimination as det(), but the pivots are accumulated as a sign and a
+    sum of logarithms, so the result cannot overflow or underflow. A pivot
+    only counts as zero relative to the size of the entries, not below 1e-9.
+    output: 0 on allocation failure; a singular matrix gives sign 0, -inf
+*/
+int log_det(double **matrix, int n, int *sign, double *log_abs) {
+    double **temp;
+    if (!allocate_matrix(&temp, n, n)) {
+        return 0;
+    }
+
+    copy_matrix(matrix, temp, n);
+    double tolerance = max_abs_element(temp, n) * n * DBL_EPSILON;
+
+    *sign = 1;
+    *log_abs = 0.0;
+    for (int i = 0; i < n && *sign != 0; i++) {
+        int pivot_row = find_pivot(temp, i, n);
+
+        if (fabs(temp[pivot_row][i]) <= tolerance) {
+            *sign = 0;
+            *log_abs = -INFINITY;
+        } else {
+            if (pivot_row != i) {
+                swap_rows(temp, i, pivot_row, n);
+                *sign = -*sign;
+            }
+            if (temp[i][i] < 0.0) {
+                *sign = -*sign;
+            }
+            *log_abs += log(fabs(temp[i][i]));
+            eliminate_column(temp, i, n);
+        }
+    }
+
+    free_matrix(temp, n);
+    return 1;
+}
+
 int input(double ***matrix, int *n, int *m) {
-    if (scanf("%d %d", n, m) != 2) {
+    if (!read_int(n) || !read_int(m)) {
         return 0;
     }
     if (*n <= 0 || *m <= 0) {
@@ -117,7 +175,7 @@ int input(double ***matrix, int *n, int *m) {
 
     for (int i = 0; i < *n; i++) {
         for (int j = 0; j < *m; j++) {
-            if (scanf("%lf", &(*matrix)[i][j]) != 1) {
+            if (!read_double(&(*matrix)[i][j])) {
                 free_matrix(*matrix, *n);
                 return 0;
             }
@@ -127,26 +185,74 @@ int input(double ***matrix, int *n, int *m) {
     return 1;
 }
 
-void output(double det) { printf("%.6f\n", det); }
+void output(double det) {
+    write_double(det);
+    write_char('\n');
+}
+
+void output_log(int sign, double log_abs) {
+    write_int(sign);
+    write_char(' ');
+    write_double(log_abs);
+    write_char('\n');
+}
 
-int main(void) {
+int has_flag(int argc, char **argv, const char *flag) {
+    int found = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], flag) == 0) {
+            found = 1;
+        }
+    }
+    return found;
+}
+
+/*
+    det [--file matrix.bin] [--log | --bareiss]
+    --log prints "sign log|det|", --bareiss prints the exact integer determinant.
+*/
+int main(int argc, char **argv) {
     double **matrix;
     int n, m;
-    double determinant;
+    int result = 1;
+    matrix_file file;
 
-    if (!input(&matrix, &n, &m)) {
-        printf("n/a\n");
+    if (!matrix_file_read(matrix_file_option(argc, argv), &file, &matrix, &n, &m, input)) {
+        write_string("n/a\n");
+        flush_output();
         return 0;
     }
 
     if (n != m) {
-        free_matrix(matrix, n);
-        printf("n/a\n");
+        matrix_file_release(&file, matrix, n, free_matrix);
+        write_string("n/a\n");
+        flush_output();
         return 0;
     }
 
-    determinant = det(matrix, n, m);
-    output(determinant);
-    free_matrix(matrix, n);
+    if (has_flag(argc, argv, "--log")) {
+        int sign;
+        double log_abs;
+        result = log_det(matrix, n, &sign, &log_abs);
+        if (result) {
+            output_log(sign, log_abs);
+        }
+    } else if (has_flag(argc, argv, "--bareiss")) {
+        char *determinant = integer_det(matrix, n);
+        result = determinant != NULL;
+        if (result) {
+            write_string(determinant);
+            write_char('\n');
+            free(determinant);
+        }
+    } else {
+        output(det(matrix, n, m));
+    }
+
+    matrix_file_release(&file, matrix, n, free_matrix);
+    if (!result) {
+        write_string("n/a\n");
+    }
+    flush_output();
     return 0;
 }
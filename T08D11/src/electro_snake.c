@@ -1,165 +1,80 @@
-#include <stdio.h>
 #include <stdlib.h>
 
-void sort_vertical(int **matrix, int n, int m, int **result_matrix);
-void sort_horizontal(int **matrix, int n, int m, int **result_matrix);
-int input(int ***matrix, int *n, int *m);
-void output(int **matrix, int n, int m);
+#include "matrix_io.h"
+#include "snake_sort.h"
 
-int compare(const void *a, const void *b) { return (*(int *)a - *(int *)b); }
+int input(int **elements, int *n, int *m);
+void output(const int *matrix, int n, int m);
 
-int allocate_matrix(int ***matrix, int n, int m) {
-    *matrix = (int **)malloc(n * sizeof(int *));
-    if (*matrix == NULL) {
-        return 0;
-    }
-
-    for (int i = 0; i < n; i++) {
-        (*matrix)[i] = (int *)malloc(m * sizeof(int));
-        if ((*matrix)[i] == NULL) {
-            for (int j = 0; j < i; j++) {
-                free((*matrix)[j]);
-            }
-            free(*matrix);
-            return 0;
-        }
-    }
-    return 1;
-}
-
-void free_matrix(int **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        free(matrix[i]);
-    }
-    free(matrix);
-}
-
-void sort_vertical(int **matrix, int n, int m, int **result_matrix) {
-    int *elements = (int *)malloc(n * m * sizeof(int));
-    int idx = 0;
-
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < m; j++) {
-            elements[idx] = matrix[i][j];
-            idx++;
-        }
-    }
-
-    qsort(elements, n * m, sizeof(int), compare);
-
-    idx = 0;
-    for (int j = 0; j < m; j++) {
-        if (j % 2 == 0) {
-            for (int i = 0; i < n; i++) {
-                result_matrix[i][j] = elements[idx];
-                idx++;
-            }
-        } else {
-            for (int i = n - 1; i >= 0; i--) {
-                result_matrix[i][j] = elements[idx];
-                idx++;
-            }
-        }
-    }
-
-    free(elements);
-}
-
-void sort_horizontal(int **matrix, int n, int m, int **result_matrix) {
-    int *elements = (int *)malloc(n * m * sizeof(int));
-    int idx = 0;
-
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < m; j++) {
-            elements[idx] = matrix[i][j];
-            idx++;
-        }
-    }
-
-    qsort(elements, n * m, sizeof(int), compare);
-
-    idx = 0;
-    for (int i = 0; i < n; i++) {
-        if (i % 2 == 0) {
-            for (int j = 0; j < m; j++) {
-                result_matrix[i][j] = elements[idx];
-                idx++;
-            }
-        } else {
-            for (int j = m - 1; j >= 0; j--) {
-                result_matrix[i][j] = elements[idx];
-                idx++;
-            }
-        }
-    }
-
-    free(elements);
-}
-
-int input(int ***matrix, int *n, int *m) {
-    if (scanf("%d %d", n, m) != 2) {
+int input(int **elements, int *n, int *m) {
+    if (!read_int(n) || !read_int(m)) {
         return 0;
     }
     if (*n <= 0 || *m <= 0) {
         return 0;
     }
 
-    if (!allocate_matrix(matrix, *n, *m)) {
+    *elements = (int *)malloc((size_t)*n * *m * sizeof(int));
+    if (*elements == NULL) {
         return 0;
     }
 
-    for (int i = 0; i < *n; i++) {
-        for (int j = 0; j < *m; j++) {
-            if (scanf("%d", &(*matrix)[i][j]) != 1) {
-                free_matrix(*matrix, *n);
-                return 0;
-            }
+    for (size_t i = 0; i < (size_t)*n * *m; i++) {
+        if (!read_int(&(*elements)[i])) {
+            free(*elements);
+            return 0;
         }
     }
 
     return 1;
 }
 
-void output(int **matrix, int n, int m) {
+void output(const int *matrix, int n, int m) {
     for (int i = 0; i < n; i++) {
         for (int j = 0; j < m; j++) {
-            printf("%d", matrix[i][j]);
+            write_int(matrix[(size_t)i * m + j]);
             if (j < m - 1) {
-                printf(" ");
+                write_char(' ');
             }
         }
         if (i < n - 1) {
-            printf("\n");
+            write_char('\n');
         }
     }
 }
 
 int main(void) {
-    int **matrix, **result;
+    int *elements, *result;
     int n, m;
 
-    if (!input(&matrix, &n, &m)) {
-        printf("n/a");
+    if (!input(&elements, &n, &m)) {
+        write_string("n/a");
+        flush_output();
         return 0;
     }
 
-    if (!allocate_matrix(&result, n, m)) {
-        free_matrix(matrix, n);
-        printf("n/a");
+    result = (int *)malloc((size_t)n * m * sizeof(int));
+    if (result == NULL) {
+        free(elements);
+        write_string("n/a");
+        flush_output();
         return 0;
     }
 
-    sort_vertical(matrix, n, m, result);
+    radix_sort(elements, result, (long long)n * m);
+
+    sort_vertical(elements, n, m, result);
     output(result, n, m);
 
-    printf("\n\n");
+    write_string("\n\n");
 
-    sort_horizontal(matrix, n, m, result);
+    sort_horizontal(elements, n, m, result);
     output(result, n, m);
 
-    printf("\n");
+    write_char('\n');
 
-    free_matrix(matrix, n);
-    free_matrix(result, n);
+    free(elements);
+    free(result);
+    flush_output();
     return 0;
 }
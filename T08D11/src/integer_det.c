@@ -0,0 +1,375 @@
+#include "integer_det.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_EXACT_DOUBLE 9007199254740992.0
+#define LIMB_BASE 4294967296ULL
+#define DECIMAL_CHUNK 1000000000U
+
+__extension__ typedef __int128 int128;
+
+int to_integer_matrix(double **matrix, int n, long long *values) {
+    int result = 1;
+    for (int i = 0; i < n && result; i++) {
+        for (int j = 0; j < n && result; j++) {
+            double value = matrix[i][j];
+            result = value == nearbyint(value) && fabs(value) <= MAX_EXACT_DOUBLE;
+            if (result) {
+                values[(size_t)i * n + j] = (long long)value;
+            }
+        }
+    }
+    return result;
+}
+
+/*
+    One step of fraction-free elimination: every entry right of and below the
+    pivot becomes (a_ij * a_kk - a_ik * a_kj) / previous_pivot, which divides
+    exactly and stays a minor of the input matrix.
+    output: 0 if an intermediate product overflows 128 bits
+*/
+int bareiss_step(int128 *values, int k, int128 previous, int n) {
+    const int128 *pivot_row = values + (size_t)k * n;
+    int128 pivot = pivot_row[k];
+    int result = 1;
+
+    for (int i = k + 1; i < n && result; i++) {
+        int128 *row = values + (size_t)i * n;
+        for (int j = k + 1; j < n && result; j++) {
+            int128 left, right, difference = 0;
+            result = !__builtin_mul_overflow(row[j], pivot, &left) &&
+                     !__builtin_mul_overflow(row[k], pivot_row[j], &right) &&
+                     !__builtin_sub_overflow(left, right, &difference);
+            row[j] = difference / previous;
+        }
+    }
+    return result;
+}
+
+void swap_integer_rows(int128 *values, int row1, int row2, int from, int n) {
+    for (int j = from; j < n; j++) {
+        int128 temp = values[(size_t)row1 * n + j];
+        values[(size_t)row1 * n + j] = values[(size_t)row2 * n + j];
+        values[(size_t)row2 * n + j] = temp;
+    }
+}
+
+/*
+    output: 1 and the determinant, 0 on overflow or allocation failure
+*/
+int bareiss_det(const long long *input, int n, int128 *determinant) {
+    int128 *values = (int128 *)malloc((size_t)n * n * sizeof(int128));
+    if (values == NULL) {
+        return 0;
+    }
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        values[i] = input[i];
+    }
+
+    int result = 1;
+    int128 previous = 1;
+    int sign = 1;
+    *determinant = 0;
+
+    for (int k = 0; k < n && result; k++) {
+        int row = k;
+        while (row < n && values[(size_t)row * n + k] == 0) {
+            row++;
+        }
+        if (row == n) {
+            break;
+        }
+        if (row != k) {
+            swap_integer_rows(values, k, row, k, n);
+            sign = -sign;
+        }
+        result = bareiss_step(values, k, previous, n);
+        previous = values[(size_t)k * n + k];
+        if (k == n - 1) {
+            *determinant = sign * previous;
+        }
+    }
+
+    free(values);
+    return result;
+}
+
+char *int128_to_string(int128 value) {
+    char digits[48];
+    int len = 0;
+    int negative = value < 0;
+
+    do {
+        int digit = (int)(value % 10);
+        digits[len++] = (char)('0' + (digit < 0 ? -digit : digit));
+        value /= 10;
+    } while (value != 0);
+
+    char *text = (char *)malloc(len + 2);
+    if (text != NULL) {
+        int pos = 0;
+        if (negative) {
+            text[pos++] = '-';
+        }
+        while (len > 0) {
+            text[pos++] = digits[--len];
+        }
+        text[pos] = '\0';
+    }
+    return text;
+}
+
+unsigned long long power_mod(unsigned long long base, unsigned long long exponent, unsigned long long p) {
+    unsigned long long result = 1;
+    base %= p;
+    while (exponent > 0) {
+        if (exponent & 1) {
+            result = result * base % p;
+        }
+        base = base * base % p;
+        exponent >>= 1;
+    }
+    return result;
+}
+
+unsigned int next_prime_below(unsigned int value) {
+    unsigned int candidate = value - 1;
+    int prime = 0;
+    while (!prime) {
+        prime = candidate % 2 != 0;
+        for (unsigned int d = 3; prime && d * d <= candidate; d += 2) {
+            prime = candidate % d != 0;
+        }
+        if (!prime) {
+            candidate--;
+        }
+    }
+    return candidate;
+}
+
+/*
+    Gaussian elimination over Z_p; work holds n * n residues.
+*/
+unsigned long long det_mod_prime(const long long *input, int n, unsigned long long p,
+                                 unsigned long long *work) {
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        long long residue = input[i] % (long long)p;
+        work[i] = (unsigned long long)(residue < 0 ? residue + (long long)p : residue);
+    }
+
+    unsigned long long determinant = 1;
+    for (int k = 0; k < n && determinant != 0; k++) {
+        int row = k;
+        while (row < n && work[(size_t)row * n + k] == 0) {
+            row++;
+        }
+        if (row == n) {
+            determinant = 0;
+        } else {
+            if (row != k) {
+                for (int j = k; j < n; j++) {
+                    unsigned long long temp = work[(size_t)k * n + j];
+                    work[(size_t)k * n + j] = work[(size_t)row * n + j];
+                    work[(size_t)row * n + j] = temp;
+                }
+                determinant = p - determinant;
+            }
+            unsigned long long *pivot_row = work + (size_t)k * n;
+            determinant = determinant * pivot_row[k] % p;
+            unsigned long long inverse = power_mod(pivot_row[k], p - 2, p);
+            for (int i = k + 1; i < n; i++) {
+                unsigned long long *target = work + (size_t)i * n;
+                unsigned long long factor = target[k] * inverse % p;
+                if (factor != 0) {
+                    for (int j = k + 1; j < n; j++) {
+                        target[j] = (target[j] + (p - factor) * pivot_row[j]) % p;
+                    }
+                }
+            }
+        }
+    }
+    return determinant % p;
+}
+
+double hadamard_bits(const long long *input, int n) {
+    double bits = 0.0;
+    for (int i = 0; i < n; i++) {
+        double norm = 0.0;
+        for (int j = 0; j < n; j++) {
+            double value = (double)input[(size_t)i * n + j];
+            norm += value * value;
+        }
+        bits += (norm > 0.0) ? 0.5 * log2(norm) : 0.0;
+    }
+    return bits;
+}
+
+/*
+    Little-endian base 2^32 magnitude: number = number * factor + addend.
+*/
+void limbs_multiply_add(unsigned int *limbs, int *size, unsigned int factor, unsigned int addend) {
+    unsigned long long carry = addend;
+    for (int i = 0; i < *size; i++) {
+        carry += (unsigned long long)limbs[i] * factor;
+        limbs[i] = (unsigned int)carry;
+        carry >>= 32;
+    }
+    if (carry != 0) {
+        limbs[(*size)++] = (unsigned int)carry;
+    }
+}
+
+unsigned int limbs_divide(unsigned int *limbs, int *size, unsigned int divisor) {
+    unsigned long long remainder = 0;
+    for (int i = *size - 1; i >= 0; i--) {
+        remainder = remainder * LIMB_BASE + limbs[i];
+        limbs[i] = (unsigned int)(remainder / divisor);
+        remainder %= divisor;
+    }
+    while (*size > 0 && limbs[*size - 1] == 0) {
+        (*size)--;
+    }
+    return (unsigned int)remainder;
+}
+
+int limbs_compare(const unsigned int *left, int left_size, const unsigned int *right, int right_size) {
+    int compare = (left_size > right_size) - (left_size < right_size);
+    for (int i = left_size - 1; i >= 0 && compare == 0; i--) {
+        compare = (left[i] > right[i]) - (left[i] < right[i]);
+    }
+    return compare;
+}
+
+/*
+    Residues above modulus / 2 stand for value - modulus: value is then
+    replaced by modulus - value and 1 (negative) is returned.
+*/
+int limbs_symmetric(unsigned int *value, int *value_size, unsigned int *modulus, int modulus_size) {
+    int half_size = modulus_size;
+    limbs_divide(modulus, &half_size, 2);
+    int negative = limbs_compare(value, *value_size, modulus, half_size) > 0;
+    limbs_multiply_add(modulus, &half_size, 2, 1);
+
+    if (negative) {
+        long long borrow = 0;
+        for (int i = 0; i < modulus_size; i++) {
+            long long digit = (long long)modulus[i] - (i < *value_size ? (long long)value[i] : 0) - borrow;
+            borrow = digit < 0;
+            value[i] = (unsigned int)(digit + (borrow ? (long long)LIMB_BASE : 0));
+        }
+        *value_size = modulus_size;
+        while (*value_size > 0 && value[*value_size - 1] == 0) {
+            (*value_size)--;
+        }
+    }
+    return negative;
+}
+
+char *limbs_to_string(unsigned int *limbs, int size, int negative) {
+    int capacity = size * 10 + 3;
+    char *text = (char *)malloc(capacity);
+    if (text == NULL) {
+        return NULL;
+    }
+
+    int len = 0;
+    do {
+        unsigned int chunk = limbs_divide(limbs, &size, DECIMAL_CHUNK);
+        for (int d = 0; d < 9 && (size > 0 || chunk > 0 || d == 0); d++) {
+            text[len++] = (char)('0' + chunk % 10);
+            chunk /= 10;
+        }
+    } while (size > 0);
+
+    if (negative && !(len == 1 && text[0] == '0')) {
+        text[len++] = '-';
+    }
+    for (int i = 0; i < len / 2; i++) {
+        char temp = text[i];
+        text[i] = text[len - 1 - i];
+        text[len - 1 - i] = temp;
+    }
+    text[len] = '\0';
+    return text;
+}
+
+/*
+    Garner's mixed-radix reconstruction from the residues, then Horner
+    evaluation into limbs.
+*/
+char *reconstruct(const unsigned int *primes, unsigned long long *residues, int count) {
+    for (int k = 1; k < count; k++) {
+        unsigned long long p = primes[k];
+        unsigned long long value = 0;
+        unsigned long long product = 1;
+        for (int i = 0; i < k; i++) {
+            value = (value + residues[i] % p * product) % p;
+            product = product * primes[i] % p;
+        }
+        residues[k] = (residues[k] + p - value) % p * power_mod(product, p - 2, p) % p;
+    }
+
+    unsigned int *value = (unsigned int *)calloc(count + 1, sizeof(unsigned int));
+    unsigned int *modulus = (unsigned int *)calloc(count + 1, sizeof(unsigned int));
+    char *text = NULL;
+    if (value != NULL && modulus != NULL) {
+        int value_size = 0;
+        int modulus_size = 1;
+        modulus[0] = 1;
+        for (int k = count - 1; k >= 0; k--) {
+            limbs_multiply_add(value, &value_size, primes[k], (unsigned int)residues[k]);
+            limbs_multiply_add(modulus, &modulus_size, primes[k], 0);
+        }
+        int negative = limbs_symmetric(value, &value_size, modulus, modulus_size);
+        text = limbs_to_string(value, value_size, negative);
+    }
+
+    free(value);
+    free(modulus);
+    return text;
+}
+
+char *modular_det(const long long *input, int n) {
+    int count = (int)(hadamard_bits(input, n) / 30.0) + 2;
+    unsigned int *primes = (unsigned int *)malloc(count * sizeof(unsigned int));
+    unsigned long long *residues = (unsigned long long *)malloc(count * sizeof(unsigned long long));
+    unsigned long long *work = (unsigned long long *)malloc((size_t)n * n * sizeof(unsigned long long));
+
+    char *text = NULL;
+    if (primes != NULL && residues != NULL && work != NULL) {
+        unsigned int prime = 2147483648U;
+        for (int k = 0; k < count; k++) {
+            prime = next_prime_below(prime);
+            primes[k] = prime;
+            residues[k] = det_mod_prime(input, n, prime, work);
+        }
+        text = reconstruct(primes, residues, count);
+    }
+
+    free(primes);
+    free(residues);
+    free(work);
+    return text;
+}
+
+char *integer_det(double **matrix, int n) {
+    long long *values = (long long *)malloc((size_t)n * n * sizeof(long long));
+    if (values == NULL) {
+        return NULL;
+    }
+
+    char *text = NULL;
+    if (to_integer_matrix(matrix, n, values)) {
+        int128 determinant;
+        if (bareiss_det(values, n, &determinant)) {
+            text = int128_to_string(determinant);
+        } else {
+            text = modular_det(values, n);
+        }
+    }
+
+    free(values);
+    return text;
+}
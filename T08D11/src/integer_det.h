@@ -0,0 +1,15 @@
+#ifndef INTEGER_DET_H
+#define INTEGER_DET_H
+
+/*
+    Exact determinant of a square matrix whose entries are all integers.
+    Fraction-free Bareiss elimination in 128-bit integers is tried first;
+    if an intermediate product overflows, the determinant is recomputed
+    modulo enough 31-bit primes to cover the Hadamard bound and rebuilt
+    with the Chinese remainder theorem, so any size is exact.
+    output: malloc'ed decimal string, or NULL for non-integer entries or
+            allocation failure
+*/
+char *integer_det(double **matrix, int n);
+
+#endif
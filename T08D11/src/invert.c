@@ -1,8 +1,15 @@
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "matrix_file.h"
+#include "matrix_io.h"
+
+#define SOLVE_BLOCK 64
 
 int invert(double **matrix, int n, int m);
+int invert_lu(double **matrix, int n, int m);
+int invert_lu_inplace(double **matrix, int n, int m);
 int input(double ***matrix, int *n, int *m);
 void output(double **matrix, int n, int m);
 
@@ -152,8 +159,221 @@ int invert(double **matrix, int n, int m) {
     return 1;
 }
 
+/*
+    LU factorization with partial pivoting, in place: row i of the result holds
+    the multipliers of L left of the diagonal and U from the diagonal on.
+    Row interchanges are applied by swapping row pointers and recorded in ipiv.
+*/
+int lu_decompose(double **matrix, int *ipiv, int n) {
+    for (int i = 0; i < n; i++) {
+        int pivot_row = find_pivot_row(matrix, i, n);
+        ipiv[i] = pivot_row;
+
+        if (fabs(matrix[pivot_row][i]) < 1e-9) {
+            return 0;
+        }
+
+        if (pivot_row != i) {
+            double *temp = matrix[i];
+            matrix[i] = matrix[pivot_row];
+            matrix[pivot_row] = temp;
+        }
+
+        double *pivot = matrix[i];
+        double inv_pivot = 1.0 / pivot[i];
+        for (int k = i + 1; k < n; k++) {
+            double *row = matrix[k];
+            if (fabs(row[i]) > 1e-9) {
+                double factor = row[i] * inv_pivot;
+                row[i] = factor;
+                for (int j = i + 1; j < n; j++) {
+                    row[j] -= factor * pivot[j];
+                }
+            } else {
+                row[i] = 0.0;
+            }
+        }
+    }
+    return 1;
+}
+
+void lu_forward_block(double **lu, double **x, int first, int col, int width, int n) {
+    for (int i = first + 1; i < n; i++) {
+        double *target = x[i] + col;
+        for (int k = first; k < i; k++) {
+            double factor = lu[i][k];
+            if (factor != 0.0) {
+                const double *source = x[k] + col;
+                for (int j = 0; j < width; j++) {
+                    target[j] -= factor * source[j];
+                }
+            }
+        }
+    }
+}
+
+void lu_backward_block(double **lu, double **x, int col, int width, int n) {
+    for (int i = n - 1; i >= 0; i--) {
+        double *target = x[i] + col;
+        for (int k = i + 1; k < n; k++) {
+            double factor = lu[i][k];
+            if (factor != 0.0) {
+                const double *source = x[k] + col;
+                for (int j = 0; j < width; j++) {
+                    target[j] -= factor * source[j];
+                }
+            }
+        }
+        double inv_diag = 1.0 / lu[i][i];
+        for (int j = 0; j < width; j++) {
+            target[j] *= inv_diag;
+        }
+    }
+}
+
+/*
+    Solves L * U * X = P * I for X, SOLVE_BLOCK columns at a time, so the rows
+    of the right-hand side being updated stay in cache. The block of P * I is
+    zero above row first, so the forward sweep starts there.
+*/
+void lu_solve_identity(double **lu, const int *perm, double **x, int n) {
+    for (int col = 0; col < n; col += SOLVE_BLOCK) {
+        int width = (n - col < SOLVE_BLOCK) ? n - col : SOLVE_BLOCK;
+        int first = n;
+
+        for (int i = 0; i < n; i++) {
+            memset(x[i] + col, 0, width * sizeof(double));
+            if (perm[i] >= col && perm[i] < col + width) {
+                x[i][perm[i]] = 1.0;
+                if (i < first) {
+                    first = i;
+                }
+            }
+        }
+
+        lu_forward_block(lu, x, first, col, width, n);
+        lu_backward_block(lu, x, col, width, n);
+    }
+}
+
+void pivots_to_permutation(const int *ipiv, int *perm, int n) {
+    for (int i = 0; i < n; i++) {
+        perm[i] = i;
+    }
+    for (int i = 0; i < n; i++) {
+        int temp = perm[i];
+        perm[i] = perm[ipiv[i]];
+        perm[ipiv[i]] = temp;
+    }
+}
+
+int invert_lu(double **matrix, int n, int m) {
+    if (n != m) {
+        return 0;
+    }
+
+    double **lu = NULL;
+    int *ipiv = (int *)malloc(n * sizeof(int));
+    int *perm = (int *)malloc(n * sizeof(int));
+    if (ipiv == NULL || perm == NULL || !allocate_matrix(&lu, n, n)) {
+        free(ipiv);
+        free(perm);
+        return 0;
+    }
+
+    for (int i = 0; i < n; i++) {
+        memcpy(lu[i], matrix[i], n * sizeof(double));
+    }
+
+    int result = lu_decompose(lu, ipiv, n);
+    if (result) {
+        pivots_to_permutation(ipiv, perm, n);
+        lu_solve_identity(lu, perm, matrix, n);
+    }
+
+    free_matrix(lu, n);
+    free(ipiv);
+    free(perm);
+    return result;
+}
+
+void invert_upper(double **matrix, int n) {
+    for (int j = 0; j < n; j++) {
+        matrix[j][j] = 1.0 / matrix[j][j];
+        double diag = -matrix[j][j];
+
+        for (int i = 0; i < j; i++) {
+            double sum = 0.0;
+            for (int k = i; k < j; k++) {
+                sum += matrix[i][k] * matrix[k][j];
+            }
+            matrix[i][j] = sum * diag;
+        }
+    }
+}
+
+void solve_unit_lower_right(double **matrix, double *work, int n) {
+    for (int j = n - 1; j >= 0; j--) {
+        for (int i = j + 1; i < n; i++) {
+            work[i] = matrix[i][j];
+            matrix[i][j] = 0.0;
+        }
+
+        for (int r = 0; r < n; r++) {
+            double *row = matrix[r];
+            double sum = 0.0;
+            for (int k = j + 1; k < n; k++) {
+                sum += row[k] * work[k];
+            }
+            row[j] -= sum;
+        }
+    }
+}
+
+void swap_columns(double **matrix, int col1, int col2, int n) {
+    for (int i = 0; i < n; i++) {
+        double temp = matrix[i][col1];
+        matrix[i][col1] = matrix[i][col2];
+        matrix[i][col2] = temp;
+    }
+}
+
+/*
+    inv(A) = inv(U) * inv(L) * P computed over the factors themselves: U is
+    inverted in place, then X * L = inv(U) is solved column by column from the
+    right. Needs one vector of workspace instead of two extra matrices.
+*/
+int invert_lu_inplace(double **matrix, int n, int m) {
+    if (n != m) {
+        return 0;
+    }
+
+    int *ipiv = (int *)malloc(n * sizeof(int));
+    double *work = (double *)malloc(n * sizeof(double));
+    if (ipiv == NULL || work == NULL) {
+        free(ipiv);
+        free(work);
+        return 0;
+    }
+
+    int result = lu_decompose(matrix, ipiv, n);
+    if (result) {
+        invert_upper(matrix, n);
+        solve_unit_lower_right(matrix, work, n);
+        for (int j = n - 2; j >= 0; j--) {
+            if (ipiv[j] != j) {
+                swap_columns(matrix, j, ipiv[j], n);
+            }
+        }
+    }
+
+    free(ipiv);
+    free(work);
+    return result;
+}
+
 int input(double ***matrix, int *n, int *m) {
-    if (scanf("%d %d", n, m) != 2) {
+    if (!read_int(n) || !read_int(m)) {
         return 0;
     }
     if (*n <= 0 || *m <= 0) {
@@ -166,7 +386,7 @@ int input(double ***matrix, int *n, int *m) {
 
     for (int i = 0; i < *n; i++) {
         for (int j = 0; j < *m; j++) {
-            if (scanf("%lf", &(*matrix)[i][j]) != 1) {
+            if (!read_double(&(*matrix)[i][j])) {
                 free_matrix(*matrix, *n);
                 return 0;
             }
@@ -179,30 +399,52 @@ int input(double ***matrix, int *n, int *m) {
 void output(double **matrix, int n, int m) {
     for (int i = 0; i < n; i++) {
         for (int j = 0; j < m; j++) {
-            printf("%.6f", matrix[i][j]);
+            write_double(matrix[i][j]);
             if (j < m - 1) {
-                printf(" ");
+                write_char(' ');
             }
         }
-        printf("\n");
+        write_char('\n');
+    }
+}
+
+int has_flag(int argc, char **argv, const char *flag) {
+    int found = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], flag) == 0) {
+            found = 1;
+        }
     }
+    return found;
 }
 
-void main() {
+int main(int argc, char **argv) {
     double **matrix;
     int n, m;
+    int (*method)(double **, int, int) = invert;
+    matrix_file file;
+
+    if (has_flag(argc, argv, "--lu")) {
+        method = invert_lu;
+    } else if (has_flag(argc, argv, "--lu-inplace")) {
+        method = invert_lu_inplace;
+    }
 
-    if (!input(&matrix, &n, &m)) {
-        printf("n/a");
-        return;
+    if (!matrix_file_read(matrix_file_option(argc, argv), &file, &matrix, &n, &m, input)) {
+        write_string("n/a");
+        flush_output();
+        return 0;
     }
 
-    if (!invert(matrix, n, m)) {
-        free_matrix(matrix, n);
-        printf("n/a");
-        return;
+    if (!method(matrix, n, m)) {
+        matrix_file_release(&file, matrix, n, free_matrix);
+        write_string("n/a");
+        flush_output();
+        return 0;
     }
 
     output(matrix, n, m);
-    free_matrix(matrix, n);
-}
\ No newline at end of file
+    matrix_file_release(&file, matrix, n, free_matrix);
+    flush_output();
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "matrix_file.h"
+#include "matrix_io.h"
+
+#define CONVERT_CHUNK 8192
+
+int text_to_binary(const char *path);
+int binary_to_text(const char *path);
+
+int write_payload(FILE *out, long long count) {
+    double chunk[CONVERT_CHUNK];
+    int result = 1;
+    while (count > 0 && result) {
+        int size = (count < CONVERT_CHUNK) ? (int)count : CONVERT_CHUNK;
+        for (int i = 0; i < size && result; i++) {
+            result = read_double(&chunk[i]);
+        }
+        result = result && fwrite(chunk, sizeof(double), size, out) == (size_t)size;
+        count -= size;
+    }
+    return result;
+}
+
+/*
+    Streams the text matrix from stdin into the binary file, so the whole
+    matrix is never held in memory.
+*/
+int text_to_binary(const char *path) {
+    int n, m;
+    if (!read_int(&n) || !read_int(&m) || n <= 0 || m <= 0) {
+        return 0;
+    }
+
+    FILE *out = fopen(path, "wb");
+    if (out == NULL) {
+        return 0;
+    }
+
+    matrix_file_header header;
+    matrix_file_header_init(&header, n, m);
+    char padding[MATRIX_FILE_ALIGNMENT] = {0};
+    int result = fwrite(&header, sizeof(header), 1, out) == 1 &&
+                 fwrite(padding, 1, header.payload_offset - sizeof(header), out) ==
+                     header.payload_offset - sizeof(header) &&
+                 write_payload(out, (long long)n * m);
+
+    result = (fclose(out) == 0) && result;
+    if (!result) {
+        remove(path);
+    }
+    return result;
+}
+
+int binary_to_text(const char *path) {
+    matrix_file file;
+    if (!matrix_file_open(&file, path)) {
+        return 0;
+    }
+
+    char text[32];
+    snprintf(text, sizeof(text), "%d %d\n", file.n, file.m);
+    write_string(text);
+    for (int i = 0; i < file.n; i++) {
+        for (int j = 0; j < file.m; j++) {
+            snprintf(text, sizeof(text), "%.17g", file.rows[i][j]);
+            write_string(text);
+            write_char(j < file.m - 1 ? ' ' : '\n');
+        }
+    }
+
+    matrix_file_close(&file);
+    return 1;
+}
+
+/*
+    matrix_convert --to-binary matrix.bin < matrix.txt
+    matrix_convert --to-text matrix.bin > matrix.txt
+    Text values are written with 17 significant digits, so a round trip is exact.
+*/
+int main(int argc, char **argv) {
+    int result = 0;
+
+    if (argc == 3 && strcmp(argv[1], "--to-binary") == 0) {
+        result = text_to_binary(argv[2]);
+    } else if (argc == 3 && strcmp(argv[1], "--to-text") == 0) {
+        result = binary_to_text(argv[2]);
+    }
+
+    if (!result) {
+        write_string("n/a");
+    }
+    flush_output();
+    return 0;
+}
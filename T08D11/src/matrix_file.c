@@ -0,0 +1,120 @@
+#include "matrix_file.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void matrix_file_header_init(matrix_file_header *header, int n, int m) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, MATRIX_FILE_MAGIC, sizeof(header->magic));
+    header->version = MATRIX_FILE_VERSION;
+    header->n = n;
+    header->m = m;
+    header->dtype = MATRIX_FLOAT64;
+    header->alignment = MATRIX_FILE_ALIGNMENT;
+    header->payload_offset = MATRIX_FILE_ALIGNMENT;
+}
+
+int header_is_valid(const matrix_file_header *header, size_t size) {
+    int result = memcmp(header->magic, MATRIX_FILE_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == MATRIX_FILE_VERSION && header->dtype == MATRIX_FLOAT64 &&
+                 header->n > 0 && header->m > 0 && header->alignment >= sizeof(double) &&
+                 (header->alignment & (header->alignment - 1)) == 0 &&
+                 header->payload_offset >= sizeof(*header) &&
+                 header->payload_offset % header->alignment == 0;
+    if (result) {
+        unsigned long long payload = (unsigned long long)header->n * (unsigned long long)header->m;
+        result = header->payload_offset <= size && payload <= (size - header->payload_offset) / sizeof(double);
+    }
+    return result;
+}
+
+int map_rows(matrix_file *file, const matrix_file_header *header) {
+    file->n = header->n;
+    file->m = header->m;
+    file->rows = (double **)malloc(file->n * sizeof(double *));
+    if (file->rows == NULL) {
+        return 0;
+    }
+
+    double *payload = (double *)((char *)file->mapping + header->payload_offset);
+    for (int i = 0; i < file->n; i++) {
+        file->rows[i] = payload + (size_t)i * file->m;
+    }
+    return 1;
+}
+
+int matrix_file_open(matrix_file *file, const char *path) {
+    file->rows = NULL;
+    file->mapping = MAP_FAILED;
+    file->size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat info;
+    int result = fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(matrix_file_header);
+    if (result) {
+        file->size = (size_t)info.st_size;
+        file->mapping = mmap(NULL, file->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        result = file->mapping != MAP_FAILED;
+    }
+    close(fd);
+
+    if (result) {
+        const matrix_file_header *header = (const matrix_file_header *)file->mapping;
+        result = header_is_valid(header, file->size) && map_rows(file, header);
+    }
+    if (!result) {
+        matrix_file_close(file);
+    }
+    return result;
+}
+
+void matrix_file_close(matrix_file *file) {
+    free(file->rows);
+    file->rows = NULL;
+    if (file->mapping != MAP_FAILED) {
+        munmap(file->mapping, file->size);
+        file->mapping = MAP_FAILED;
+    }
+}
+
+const char *matrix_file_option(int argc, char **argv) {
+    const char *path = NULL;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--file") == 0) {
+            path = argv[i + 1];
+        }
+    }
+    return path;
+}
+
+int matrix_file_read(const char *path, matrix_file *file, double ***matrix, int *n, int *m,
+                     int (*read_input)(double ***matrix, int *n, int *m)) {
+    int result;
+    if (path == NULL) {
+        file->rows = NULL;
+        result = read_input(matrix, n, m);
+    } else {
+        result = matrix_file_open(file, path);
+        *matrix = file->rows;
+        *n = file->n;
+        *m = file->m;
+    }
+    return result;
+}
+
+void matrix_file_release(matrix_file *file, double **matrix, int n,
+                         void (*free_input)(double **matrix, int n)) {
+    if (file->rows != NULL) {
+        matrix_file_close(file);
+    } else {
+        free_input(matrix, n);
+    }
+}
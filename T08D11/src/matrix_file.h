@@ -0,0 +1,63 @@
+#ifndef MATRIX_FILE_H
+#define MATRIX_FILE_H
+
+#include <stddef.h>
+
+#define MATRIX_FILE_MAGIC "MTXB"
+#define MATRIX_FILE_VERSION 1
+#define MATRIX_FILE_ALIGNMENT 64
+#define MATRIX_FLOAT64 1
+
+/*
+    Binary matrix file: a 64-byte header followed, at payload_offset, by the
+    n * m elements in row-major order with no padding between rows. Numbers
+    are stored in the byte order of the machine that wrote the file.
+*/
+typedef struct matrix_file_header {
+    char magic[4];
+    unsigned int version;
+    int n;
+    int m;
+    unsigned int dtype;
+    unsigned int alignment;
+    unsigned long long payload_offset;
+    char reserved[32];
+} matrix_file_header;
+
+/*
+    A file mapped copy-on-write: rows point straight into the mapping, so
+    loading touches no data and in-place updates never reach the file.
+*/
+typedef struct matrix_file {
+    int n;
+    int m;
+    double **rows;
+    void *mapping;
+    size_t size;
+} matrix_file;
+
+int matrix_file_open(matrix_file *file, const char *path);
+void matrix_file_close(matrix_file *file);
+
+void matrix_file_header_init(matrix_file_header *header, int n, int m);
+
+/*
+    output: the path following "--file" in argv, or NULL when reading stdin
+*/
+const char *matrix_file_option(int argc, char **argv);
+
+/*
+    Loads the matrix from the binary file at path, or with the tool's own
+    read_input from stdin when path is NULL. n and m are set either way.
+*/
+int matrix_file_read(const char *path, matrix_file *file, double ***matrix, int *n, int *m,
+                     int (*read_input)(double ***matrix, int *n, int *m));
+
+/*
+    Releases a matrix loaded by matrix_file_read: unmaps the file, or frees
+    the rows read from stdin with free_input.
+*/
+void matrix_file_release(matrix_file *file, double **matrix, int n,
+                         void (*free_input)(double **matrix, int n));
+
+#endif
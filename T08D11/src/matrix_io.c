@@ -0,0 +1,282 @@
+#include "matrix_io.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TOKEN_SIZE 64
+#define FAST_PATH_LIMIT 1e9
+
+static char in_buffer[IO_BUFFER_SIZE];
+static size_t in_pos = 0;
+static size_t in_len = 0;
+
+static char out_buffer[IO_BUFFER_SIZE];
+static size_t out_len = 0;
+
+static const double powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                       1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                       1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static int peek_char(void) {
+    if (in_pos == in_len) {
+        in_len = fread(in_buffer, 1, IO_BUFFER_SIZE, stdin);
+        in_pos = 0;
+    }
+    return (in_pos < in_len) ? (unsigned char)in_buffer[in_pos] : EOF;
+}
+
+static void skip_spaces(void) {
+    int ch = peek_char();
+    while (ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' || ch == '\v' || ch == '\f') {
+        in_pos++;
+        ch = peek_char();
+    }
+}
+
+static int is_digit(int ch) { return ch >= '0' && ch <= '9'; }
+
+int read_int(int *value) {
+    skip_spaces();
+    int negative = 0;
+    int ch = peek_char();
+    if (ch == '-' || ch == '+') {
+        negative = (ch == '-');
+        in_pos++;
+        ch = peek_char();
+    }
+    if (!is_digit(ch)) {
+        return 0;
+    }
+
+    long long result = 0;
+    while (is_digit(ch)) {
+        if (result < 10000000000LL) {
+            result = result * 10 + (ch - '0');
+        }
+        in_pos++;
+        ch = peek_char();
+    }
+    *value = (int)(negative ? -result : result);
+    return 1;
+}
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t capacity;
+    char small[TOKEN_SIZE];
+} token_buffer;
+
+/*
+    Tokens start in the inline buffer and move to the heap when they outgrow
+    it, so a long number is read whole like scanf("%lf") reads it.
+    output: 0 if the heap buffer can't grow
+*/
+static int push_char(token_buffer *token, int ch) {
+    if (token->len + 1 == token->capacity) {
+        size_t capacity = token->capacity * 2;
+        char *data = (token->data == token->small) ? malloc(capacity) : realloc(token->data, capacity);
+        if (data == NULL) {
+            return 0;
+        }
+        if (token->data == token->small) {
+            memcpy(data, token->small, token->len);
+        }
+        token->data = data;
+        token->capacity = capacity;
+    }
+    token->data[token->len++] = (char)ch;
+    in_pos++;
+    return 1;
+}
+
+static int is_letter(int ch) { return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z'); }
+
+/*
+    Copies the longest prefix shaped like [+-]digits[.digits][e[+-]digits] into
+    token, or an alphabetic word such as inf/nan after the sign.
+    output: token length, 0 if there is no number or memory ran out
+*/
+static size_t take_token(token_buffer *token) {
+    int ch = peek_char();
+    int has_digits = 0, ok = 1;
+
+    if (ch == '-' || ch == '+') {
+        ok = push_char(token, ch);
+        ch = peek_char();
+    }
+    if (is_letter(ch)) {
+        while (ok && is_letter(ch)) {
+            ok = push_char(token, ch);
+            ch = peek_char();
+        }
+        token->data[token->len] = '\0';
+        return ok ? token->len : 0;
+    }
+
+    int stage = 0;
+    while (ok) {
+        char last = token->len ? token->data[token->len - 1] : '\0';
+        if (is_digit(ch)) {
+            has_digits = 1;
+        } else if (ch == '.' && stage == 0) {
+            stage = 1;
+        } else if ((ch == 'e' || ch == 'E') && stage < 2 && has_digits) {
+            stage = 2;
+        } else if ((ch == '-' || ch == '+') && stage == 2 && (last == 'e' || last == 'E')) {
+            stage = 2;
+        } else {
+            break;
+        }
+        ok = push_char(token, ch);
+        ch = peek_char();
+    }
+    token->data[token->len] = '\0';
+    return (ok && has_digits) ? token->len : 0;
+}
+
+/*
+    Exact when the digits fit in 53 bits and the decimal exponent is within
+    the exactly representable powers of ten; everything else goes to strtod.
+*/
+static int parse_fast(const char *token, double *value) {
+    const char *p = token;
+    int negative = (*p == '-');
+    if (*p == '-' || *p == '+') {
+        p++;
+    }
+
+    unsigned long long mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    for (; is_digit(*p); p++) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (unsigned long long)(*p - '0');
+            digits += (mantissa != 0);
+        } else {
+            exponent++;
+        }
+    }
+    if (*p == '.') {
+        for (p++; is_digit(*p); p++) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (unsigned long long)(*p - '0');
+                digits += (mantissa != 0);
+                exponent--;
+            }
+        }
+    }
+    if (*p == 'e' || *p == 'E') {
+        return 0;
+    }
+
+    int result = *p == '\0' && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22;
+    if (result) {
+        double number = (double)mantissa;
+        number = (exponent < 0) ? number / powers_of_ten[-exponent] : number * powers_of_ten[exponent];
+        *value = negative ? -number : number;
+    }
+    return result;
+}
+
+int read_double(double *value) {
+    token_buffer token;
+    token.data = token.small;
+    token.len = 0;
+    token.capacity = TOKEN_SIZE;
+    skip_spaces();
+
+    int result = take_token(&token) != 0;
+    if (result && !parse_fast(token.data, value)) {
+        char *end;
+        *value = strtod(token.data, &end);
+        result = end != token.data;
+    }
+    if (token.data != token.small) {
+        free(token.data);
+    }
+    return result;
+}
+
+void flush_output(void) {
+    if (out_len > 0) {
+        fwrite(out_buffer, 1, out_len, stdout);
+        out_len = 0;
+    }
+    fflush(stdout);
+}
+
+static void reserve(size_t size) {
+    if (out_len + size > IO_BUFFER_SIZE) {
+        fwrite(out_buffer, 1, out_len, stdout);
+        out_len = 0;
+    }
+}
+
+void write_char(char ch) {
+    reserve(1);
+    out_buffer[out_len++] = ch;
+}
+
+void write_string(const char *str) {
+    size_t len = strlen(str);
+    if (len > IO_BUFFER_SIZE) {
+        flush_output();
+        fwrite(str, 1, len, stdout);
+    } else {
+        reserve(len);
+        memcpy(out_buffer + out_len, str, len);
+        out_len += len;
+    }
+}
+
+static void write_unsigned(unsigned long long value, int min_digits) {
+    char digits[24];
+    int len = 0;
+    do {
+        digits[len++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0 || len < min_digits);
+
+    reserve(len);
+    while (len > 0) {
+        out_buffer[out_len++] = digits[--len];
+    }
+}
+
+void write_int(int value) {
+    long long wide = value;
+    if (wide < 0) {
+        write_char('-');
+        wide = -wide;
+    }
+    write_unsigned((unsigned long long)wide, 1);
+}
+
+/*
+    Rounds |value| * 1e6 by hand. When the product lands too close to a
+    rounding boundary to trust, printf decides, so the output is identical.
+*/
+void write_double(double value) {
+    double magnitude = fabs(value);
+    double scaled = magnitude * 1e6;
+    double whole = floor(scaled);
+    double fraction = scaled - whole;
+
+    if (!isfinite(value) || magnitude >= FAST_PATH_LIMIT ||
+        fabs(fraction - 0.5) <= scaled * 4e-16 + 1e-300) {
+        char text[TOKEN_SIZE * 8];
+        snprintf(text, sizeof(text), "%.6f", value);
+        write_string(text);
+    } else {
+        unsigned long long units = (unsigned long long)whole + (fraction > 0.5);
+        if (signbit(value)) {
+            write_char('-');
+        }
+        write_unsigned(units / 1000000, 1);
+        write_char('.');
+        write_unsigned(units % 1000000, 6);
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef MATRIX_IO_H
+#define MATRIX_IO_H
+
+#define IO_BUFFER_SIZE (1 << 16)
+
+/*
+    Buffered replacements for scanf("%d") / scanf("%lf") on stdin.
+    output: 1 if a number was read, 0 on end of input or malformed number
+*/
+int read_int(int *value);
+int read_double(double *value);
+
+/*
+    Buffered replacements for printf on stdout. write_double formats like
+    "%.6f". Nothing reaches stdout before flush_output() or a full buffer.
+*/
+void write_int(int value);
+void write_double(double value);
+void write_char(char ch);
+void write_string(const char *str);
+void flush_output(void);
+
+#endif
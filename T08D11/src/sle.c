@@ -1,6 +1,10 @@
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "matrix_file.h"
+#include "matrix_io.h"
+#include "sparse.h"
 
 int sle(double **matrix, int n, int m, double *roots);
 int input(double ***matrix, int *n, int *m);
@@ -148,7 +152,7 @@ int sle(double **matrix, int n, int m, double *roots) {
 }
 
 int input(double ***matrix, int *n, int *m) {
-    if (scanf("%d %d", n, m) != 2) {
+    if (!read_int(n) || !read_int(m)) {
         return 0;
     }
     if (*n <= 0 || *m <= 0) {
@@ -161,7 +165,7 @@ int input(double ***matrix, int *n, int *m) {
 
     for (int i = 0; i < *n; i++) {
         for (int j = 0; j < *m; j++) {
-            if (scanf("%lf", &(*matrix)[i][j]) != 1) {
+            if (!read_double(&(*matrix)[i][j])) {
                 free_matrix(*matrix, *n);
                 return 0;
             }
@@ -174,52 +178,104 @@ int input(double ***matrix, int *n, int *m) {
 void output(double **matrix, int n, int m) {
     for (int i = 0; i < n; i++) {
         for (int j = 0; j < m; j++) {
-            printf("%.6f", matrix[i][j]);
+            write_double(matrix[i][j]);
             if (j < m - 1) {
-                printf(" ");
+                write_char(' ');
             }
         }
         if (i < n - 1) {
-            printf("\n");
+            write_char('\n');
         }
     }
 }
 
 void output_roots(double *roots, int n) {
     for (int i = 0; i < n; i++) {
-        printf("%.6f", roots[i]);
+        write_double(roots[i]);
         if (i < n - 1) {
-            printf(" ");
+            write_char(' ');
+        }
+    }
+    write_char('\n');
+}
+
+int has_flag(int argc, char **argv, const char *flag) {
+    int found = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], flag) == 0) {
+            found = 1;
         }
     }
-    printf("\n");
+    return found;
 }
 
-void main() {
+int solve_dense(const char *path) {
     double **matrix;
     double *roots;
     int n, m;
+    matrix_file file;
 
-    if (!input(&matrix, &n, &m)) {
-        printf("n/a");
-        return;
+    if (!matrix_file_read(path, &file, &matrix, &n, &m, input)) {
+        return 0;
     }
 
     roots = (double *)malloc(n * sizeof(double));
     if (roots == NULL) {
-        free_matrix(matrix, n);
-        printf("n/a");
-        return;
+        matrix_file_release(&file, matrix, n, free_matrix);
+        return 0;
     }
 
-    if (!sle(matrix, n, m, roots)) {
-        free_matrix(matrix, n);
-        free(roots);
-        printf("n/a");
-        return;
+    int result = sle(matrix, n, m, roots);
+    if (result) {
+        output_roots(roots, n);
     }
+    matrix_file_release(&file, matrix, n, free_matrix);
+    free(roots);
+    return result;
+}
+
+int solve_sparse(enum sparse_solver solver, enum sparse_precond precond) {
+    csr_matrix matrix;
+    double *rhs;
+    double *roots;
+    int n, m;
 
-    output_roots(roots, n);
-    free_matrix(matrix, n);
+    if (!csr_input(&matrix, &rhs, &n, &m)) {
+        return 0;
+    }
+
+    roots = (double *)malloc(n * sizeof(double));
+    int result = roots != NULL && sparse_solve(&matrix, rhs, roots, solver, precond);
+    if (result) {
+        output_roots(roots, n);
+    }
+    csr_free(&matrix);
+    free(rhs);
     free(roots);
-}
\ No newline at end of file
+    return result;
+}
+
+/*
+    sle [--file matrix.bin] [--sparse [--cg] [--jacobi]]
+    Without flags the augmented matrix is read densely from stdin, or mapped
+    from a binary matrix file with --file, and solved by Gaussian elimination.
+    --sparse reads it as triplets (see csr_input) and solves with BiCGSTAB,
+    or CG for symmetric positive definite systems, preconditioned by ILU(0)
+    unless --jacobi is given.
+*/
+int main(int argc, char **argv) {
+    int result;
+
+    if (has_flag(argc, argv, "--sparse")) {
+        result = solve_sparse(has_flag(argc, argv, "--cg") ? SOLVER_CG : SOLVER_BICGSTAB,
+                              has_flag(argc, argv, "--jacobi") ? PRECOND_JACOBI : PRECOND_ILU0);
+    } else {
+        result = solve_dense(matrix_file_option(argc, argv));
+    }
+
+    if (!result) {
+        write_string("n/a");
+    }
+    flush_output();
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "snake_sort.h"
+
+#define BENCH_COUNT 10000000LL
+#define BENCH_ROWS 2500
+#define BENCH_REPEATS 3
+
+double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int compare_ints(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+    Full 32-bit range, so both signs and every radix byte vary.
+*/
+void fill_random(int *data, long long n, unsigned int seed) {
+    unsigned int state = seed;
+    for (long long i = 0; i < n; i++) {
+        state = state * 1664525u + 1013904223u;
+        data[i] = (int)(state ^ (state >> 16));
+    }
+}
+
+int main(void) {
+    int *input = malloc(BENCH_COUNT * sizeof(int)), *expected = malloc(BENCH_COUNT * sizeof(int));
+    int *actual = malloc(BENCH_COUNT * sizeof(int)), *buffer = malloc(BENCH_COUNT * sizeof(int));
+    if (input == NULL || expected == NULL || actual == NULL || buffer == NULL) {
+        printf("n/a\n");
+    } else {
+        double best_qsort = 1e9, best_radix = 1e9, best_snake = 1e9;
+        fill_random(input, BENCH_COUNT, 12345);
+        for (int run = 0; run < BENCH_REPEATS; run++) {
+            memcpy(expected, input, BENCH_COUNT * sizeof(int));
+            double start = now_seconds();
+            qsort(expected, BENCH_COUNT, sizeof(int), compare_ints);
+            double spent = now_seconds() - start;
+            best_qsort = (spent < best_qsort) ? spent : best_qsort;
+
+            memcpy(actual, input, BENCH_COUNT * sizeof(int));
+            start = now_seconds();
+            radix_sort(actual, buffer, BENCH_COUNT);
+            spent = now_seconds() - start;
+            best_radix = (spent < best_radix) ? spent : best_radix;
+
+            start = now_seconds();
+            sort_vertical(actual, BENCH_ROWS, BENCH_COUNT / BENCH_ROWS, buffer);
+            sort_horizontal(actual, BENCH_ROWS, BENCH_COUNT / BENCH_ROWS, buffer);
+            spent = now_seconds() - start;
+            best_snake = (spent < best_snake) ? spent : best_snake;
+        }
+        int same = memcmp(expected, actual, BENCH_COUNT * sizeof(int)) == 0;
+        printf("%lld ints, best of %d\n", BENCH_COUNT, BENCH_REPEATS);
+        printf("qsort:        %7.1f ms\n", best_qsort * 1e3);
+        printf("radix_sort:   %7.1f ms, %.1fx [%s]\n", best_radix * 1e3, best_qsort / best_radix,
+               same ? "ok" : "MISMATCH");
+        printf("both layouts: %7.1f ms\n", best_snake * 1e3);
+    }
+    free(input);
+    free(expected);
+    free(actual);
+    free(buffer);
+    return 0;
+}
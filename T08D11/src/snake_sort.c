@@ -0,0 +1,82 @@
+#include "snake_sort.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define SCATTER_BLOCK 256
+
+/*
+    LSD radix sort over the key x ^ INT_MIN, which orders signed ints as
+    unsigned ones. Passes whose byte is equal for every element are skipped.
+    The result always ends up back in elements; buffer is scratch space.
+*/
+void radix_sort(int *elements, int *buffer, long long count) {
+    unsigned int *source = (unsigned int *)elements;
+    unsigned int *target = (unsigned int *)buffer;
+    long long histogram[4][RADIX_SIZE] = {{0}};
+
+    for (long long i = 0; i < count; i++) {
+        unsigned int key = source[i] ^ 0x80000000u;
+        for (int pass = 0; pass < 4; pass++) {
+            histogram[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+        }
+    }
+
+    for (int pass = 0; pass < 4; pass++) {
+        int shift = pass * RADIX_BITS;
+        if (histogram[pass][((source[0] ^ 0x80000000u) >> shift) & (RADIX_SIZE - 1)] != count) {
+            long long offset = 0;
+            for (int digit = 0; digit < RADIX_SIZE; digit++) {
+                long long size = histogram[pass][digit];
+                histogram[pass][digit] = offset;
+                offset += size;
+            }
+            for (long long i = 0; i < count; i++) {
+                unsigned int digit = ((source[i] ^ 0x80000000u) >> shift) & (RADIX_SIZE - 1);
+                target[histogram[pass][digit]++] = source[i];
+            }
+            unsigned int *temp = source;
+            source = target;
+            target = temp;
+        }
+    }
+
+    if (source != (unsigned int *)elements) {
+        memcpy(elements, source, (size_t)count * sizeof(int));
+    }
+}
+
+/*
+    Column j of the result is sorted[j * n .. j * n + n - 1], top down for
+    even j and bottom up for odd ones. The result is filled row by row within
+    blocks of SCATTER_BLOCK columns, so writes are sequential and every
+    column's read stream stays in cache between consecutive rows.
+*/
+void sort_vertical(const int *sorted, int n, int m, int *result) {
+    for (int block = 0; block < m; block += SCATTER_BLOCK) {
+        int block_end = (block + SCATTER_BLOCK < m) ? block + SCATTER_BLOCK : m;
+        for (int i = 0; i < n; i++) {
+            int *row = result + (size_t)i * m;
+            for (int j = block; j < block_end; j++) {
+                size_t column = (size_t)j * n;
+                row[j] = sorted[column + ((j % 2 == 0) ? i : n - 1 - i)];
+            }
+        }
+    }
+}
+
+void sort_horizontal(const int *sorted, int n, int m, int *result) {
+    for (int i = 0; i < n; i++) {
+        const int *source = sorted + (size_t)i * m;
+        int *row = result + (size_t)i * m;
+        if (i % 2 == 0) {
+            memcpy(row, source, (size_t)m * sizeof(int));
+        } else {
+            for (int j = 0; j < m; j++) {
+                row[j] = source[m - 1 - j];
+            }
+        }
+    }
+}
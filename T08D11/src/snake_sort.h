@@ -0,0 +1,16 @@
+#ifndef SNAKE_SORT_H
+#define SNAKE_SORT_H
+
+/*
+    Sorts count ints in ascending order; buffer holds count ints of scratch.
+*/
+void radix_sort(int *elements, int *buffer, long long count);
+
+/*
+    Lay the n * m sorted values out as a snake of columns or of rows into
+    result, an n x m matrix stored row by row.
+*/
+void sort_vertical(const int *sorted, int n, int m, int *result);
+void sort_horizontal(const int *sorted, int n, int m, int *result);
+
+#endif
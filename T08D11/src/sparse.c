@@ -0,0 +1,424 @@
+#include "sparse.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "matrix_io.h"
+
+typedef struct preconditioner {
+    enum sparse_precond kind;
+    const csr_matrix *matrix;
+    double *factors;
+    double *inv_diag;
+    int *diag_pos;
+} preconditioner;
+
+void csr_free(csr_matrix *matrix) {
+    free(matrix->row_start);
+    free(matrix->cols);
+    free(matrix->values);
+    matrix->row_start = NULL;
+    matrix->cols = NULL;
+    matrix->values = NULL;
+}
+
+void sort_row(int *cols, double *values, int count) {
+    for (int i = 1; i < count; i++) {
+        int col = cols[i];
+        double value = values[i];
+        int j = i - 1;
+        while (j >= 0 && cols[j] > col) {
+            cols[j + 1] = cols[j];
+            values[j + 1] = values[j];
+            j--;
+        }
+        cols[j + 1] = col;
+        values[j + 1] = value;
+    }
+}
+
+void merge_duplicates(csr_matrix *matrix) {
+    int write = 0;
+    int read = 0;
+    for (int i = 0; i < matrix->n; i++) {
+        int end = matrix->row_start[i + 1];
+        matrix->row_start[i] = write;
+        while (read < end) {
+            if (write > matrix->row_start[i] && matrix->cols[write - 1] == matrix->cols[read]) {
+                matrix->values[write - 1] += matrix->values[read];
+            } else {
+                matrix->cols[write] = matrix->cols[read];
+                matrix->values[write] = matrix->values[read];
+                write++;
+            }
+            read++;
+        }
+    }
+    matrix->row_start[matrix->n] = write;
+    matrix->nnz = write;
+}
+
+int csr_from_triplets(csr_matrix *matrix, int n, int nnz, const int *rows, const int *cols,
+                      const double *values) {
+    matrix->n = n;
+    matrix->nnz = nnz;
+    matrix->row_start = (int *)calloc(n + 1, sizeof(int));
+    matrix->cols = (int *)malloc((nnz > 0 ? nnz : 1) * sizeof(int));
+    matrix->values = (double *)malloc((nnz > 0 ? nnz : 1) * sizeof(double));
+    if (matrix->row_start == NULL || matrix->cols == NULL || matrix->values == NULL) {
+        csr_free(matrix);
+        return 0;
+    }
+
+    for (int k = 0; k < nnz; k++) {
+        matrix->row_start[rows[k] + 1]++;
+    }
+    for (int i = 0; i < n; i++) {
+        matrix->row_start[i + 1] += matrix->row_start[i];
+    }
+
+    int *fill = (int *)malloc(n * sizeof(int));
+    if (fill == NULL) {
+        csr_free(matrix);
+        return 0;
+    }
+    memcpy(fill, matrix->row_start, n * sizeof(int));
+    for (int k = 0; k < nnz; k++) {
+        int pos = fill[rows[k]]++;
+        matrix->cols[pos] = cols[k];
+        matrix->values[pos] = values[k];
+    }
+    free(fill);
+
+    for (int i = 0; i < n; i++) {
+        int start = matrix->row_start[i];
+        sort_row(matrix->cols + start, matrix->values + start, matrix->row_start[i + 1] - start);
+    }
+    merge_duplicates(matrix);
+    return 1;
+}
+
+int read_triplets(int n, int nnz, int *rows, int *cols, double *values, double *rhs, int *count) {
+    *count = 0;
+    for (int k = 0; k < nnz; k++) {
+        int row, col;
+        double value;
+        if (!read_int(&row) || !read_int(&col) || !read_double(&value)) {
+            return 0;
+        }
+        if (row < 0 || row >= n || col < 0 || col > n) {
+            return 0;
+        }
+        if (col == n) {
+            rhs[row] += value;
+        } else {
+            rows[*count] = row;
+            cols[*count] = col;
+            values[*count] = value;
+            (*count)++;
+        }
+    }
+    return 1;
+}
+
+int csr_input(csr_matrix *matrix, double **rhs, int *n, int *m) {
+    int nnz;
+    if (!read_int(n) || !read_int(m) || !read_int(&nnz)) {
+        return 0;
+    }
+    if (*n <= 0 || *m != *n + 1 || nnz < 0) {
+        return 0;
+    }
+
+    int *rows = (int *)malloc((nnz > 0 ? nnz : 1) * sizeof(int));
+    int *cols = (int *)malloc((nnz > 0 ? nnz : 1) * sizeof(int));
+    double *values = (double *)malloc((nnz > 0 ? nnz : 1) * sizeof(double));
+    *rhs = (double *)calloc(*n, sizeof(double));
+
+    int count = 0;
+    int result = rows != NULL && cols != NULL && values != NULL && *rhs != NULL &&
+                 read_triplets(*n, nnz, rows, cols, values, *rhs, &count) &&
+                 csr_from_triplets(matrix, *n, count, rows, cols, values);
+
+    free(rows);
+    free(cols);
+    free(values);
+    if (!result) {
+        free(*rhs);
+        *rhs = NULL;
+    }
+    return result;
+}
+
+void csr_multiply(const csr_matrix *matrix, const double *x, double *y) {
+    for (int i = 0; i < matrix->n; i++) {
+        double sum = 0.0;
+        for (int k = matrix->row_start[i]; k < matrix->row_start[i + 1]; k++) {
+            sum += matrix->values[k] * x[matrix->cols[k]];
+        }
+        y[i] = sum;
+    }
+}
+
+double dot(const double *a, const double *b, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+int find_diagonal(const csr_matrix *matrix, int *diag_pos) {
+    for (int i = 0; i < matrix->n; i++) {
+        diag_pos[i] = -1;
+        for (int k = matrix->row_start[i]; k < matrix->row_start[i + 1]; k++) {
+            if (matrix->cols[k] == i) {
+                diag_pos[i] = k;
+            }
+        }
+        if (diag_pos[i] < 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+    Incomplete LU with zero fill-in: the factors keep the sparsity pattern of
+    the matrix, L (unit diagonal) below and U on and above the diagonal.
+*/
+int ilu0_factorize(const csr_matrix *matrix, double *factors, const int *diag_pos) {
+    int n = matrix->n;
+    int *position = (int *)malloc(n * sizeof(int));
+    if (position == NULL) {
+        return 0;
+    }
+    for (int j = 0; j < n; j++) {
+        position[j] = -1;
+    }
+    memcpy(factors, matrix->values, matrix->nnz * sizeof(double));
+
+    int result = 1;
+    for (int i = 0; i < n && result; i++) {
+        int start = matrix->row_start[i];
+        int end = matrix->row_start[i + 1];
+        for (int k = start; k < end; k++) {
+            position[matrix->cols[k]] = k;
+        }
+
+        for (int k = start; k < diag_pos[i]; k++) {
+            int row = matrix->cols[k];
+            factors[k] /= factors[diag_pos[row]];
+            for (int t = diag_pos[row] + 1; t < matrix->row_start[row + 1]; t++) {
+                int pos = position[matrix->cols[t]];
+                if (pos >= 0) {
+                    factors[pos] -= factors[k] * factors[t];
+                }
+            }
+        }
+        result = fabs(factors[diag_pos[i]]) > SPARSE_EPS;
+
+        for (int k = start; k < end; k++) {
+            position[matrix->cols[k]] = -1;
+        }
+    }
+
+    free(position);
+    return result;
+}
+
+void preconditioner_free(preconditioner *precond) {
+    free(precond->factors);
+    free(precond->inv_diag);
+    free(precond->diag_pos);
+}
+
+int preconditioner_init(preconditioner *precond, const csr_matrix *matrix, enum sparse_precond kind) {
+    int n = matrix->n;
+    precond->kind = kind;
+    precond->matrix = matrix;
+    precond->factors = NULL;
+    precond->inv_diag = NULL;
+    precond->diag_pos = (int *)malloc(n * sizeof(int));
+    if (precond->diag_pos == NULL || !find_diagonal(matrix, precond->diag_pos)) {
+        preconditioner_free(precond);
+        return 0;
+    }
+
+    int result = 1;
+    if (kind == PRECOND_ILU0) {
+        precond->factors = (double *)malloc((matrix->nnz > 0 ? matrix->nnz : 1) * sizeof(double));
+        result = precond->factors != NULL && ilu0_factorize(matrix, precond->factors, precond->diag_pos);
+    } else {
+        precond->inv_diag = (double *)malloc(n * sizeof(double));
+        result = precond->inv_diag != NULL;
+        for (int i = 0; i < n && result; i++) {
+            double diag = matrix->values[precond->diag_pos[i]];
+            result = fabs(diag) > SPARSE_EPS;
+            precond->inv_diag[i] = 1.0 / diag;
+        }
+    }
+
+    if (!result) {
+        preconditioner_free(precond);
+    }
+    return result;
+}
+
+void preconditioner_apply(const preconditioner *precond, const double *r, double *z) {
+    const csr_matrix *matrix = precond->matrix;
+    int n = matrix->n;
+
+    if (precond->kind == PRECOND_JACOBI) {
+        for (int i = 0; i < n; i++) {
+            z[i] = r[i] * precond->inv_diag[i];
+        }
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        double sum = r[i];
+        for (int k = matrix->row_start[i]; k < precond->diag_pos[i]; k++) {
+            sum -= precond->factors[k] * z[matrix->cols[k]];
+        }
+        z[i] = sum;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        double sum = z[i];
+        for (int k = precond->diag_pos[i] + 1; k < matrix->row_start[i + 1]; k++) {
+            sum -= precond->factors[k] * z[matrix->cols[k]];
+        }
+        z[i] = sum / precond->factors[precond->diag_pos[i]];
+    }
+}
+
+int conjugate_gradient(const csr_matrix *matrix, const preconditioner *precond, const double *rhs,
+                       double *roots, double *work, double rhs_norm) {
+    int n = matrix->n;
+    double *r = work;
+    double *z = work + n;
+    double *p = work + 2 * n;
+    double *ap = work + 3 * n;
+
+    memcpy(r, rhs, n * sizeof(double));
+    preconditioner_apply(precond, r, z);
+    memcpy(p, z, n * sizeof(double));
+    double rz = dot(r, z, n);
+
+    int converged = 0;
+    for (int iteration = 0; iteration < 2 * n + 100 && !converged; iteration++) {
+        csr_multiply(matrix, p, ap);
+        double curvature = dot(p, ap, n);
+        if (fabs(curvature) < 1e-300) {
+            break;
+        }
+        double alpha = rz / curvature;
+        for (int i = 0; i < n; i++) {
+            roots[i] += alpha * p[i];
+            r[i] -= alpha * ap[i];
+        }
+
+        if (sqrt(dot(r, r, n)) <= SPARSE_TOLERANCE * rhs_norm) {
+            converged = 1;
+        } else {
+            preconditioner_apply(precond, r, z);
+            double rz_next = dot(r, z, n);
+            double beta = rz_next / rz;
+            rz = rz_next;
+            for (int i = 0; i < n; i++) {
+                p[i] = z[i] + beta * p[i];
+            }
+        }
+    }
+    return converged;
+}
+
+int bicgstab(const csr_matrix *matrix, const preconditioner *precond, const double *rhs, double *roots,
+             double *work, double rhs_norm) {
+    int n = matrix->n;
+    double *r = work;
+    double *r0 = work + n;
+    double *p = work + 2 * n;
+    double *v = work + 3 * n;
+    double *p_hat = work + 4 * n;
+    double *s_hat = work + 5 * n;
+    double *t = work + 6 * n;
+
+    memcpy(r, rhs, n * sizeof(double));
+    memcpy(r0, rhs, n * sizeof(double));
+    memset(p, 0, n * sizeof(double));
+    memset(v, 0, n * sizeof(double));
+    double rho = 1.0, alpha = 1.0, omega = 1.0, denominator = 1.0;
+
+    int converged = 0;
+    int breakdown = 0;
+    for (int iteration = 0; iteration < 2 * n + 100 && !converged && !breakdown; iteration++) {
+        double rho_next = dot(r0, r, n);
+        breakdown = fabs(rho_next) < 1e-300;
+        if (!breakdown) {
+            double beta = (rho_next / rho) * (alpha / omega);
+            rho = rho_next;
+            for (int i = 0; i < n; i++) {
+                p[i] = r[i] + beta * (p[i] - omega * v[i]);
+            }
+            preconditioner_apply(precond, p, p_hat);
+            csr_multiply(matrix, p_hat, v);
+            denominator = dot(r0, v, n);
+            breakdown = fabs(denominator) < 1e-300;
+        }
+        if (!breakdown) {
+            alpha = rho / denominator;
+            for (int i = 0; i < n; i++) {
+                r[i] -= alpha * v[i];
+                roots[i] += alpha * p_hat[i];
+            }
+            converged = sqrt(dot(r, r, n)) <= SPARSE_TOLERANCE * rhs_norm;
+        }
+
+        if (!converged && !breakdown) {
+            preconditioner_apply(precond, r, s_hat);
+            csr_multiply(matrix, s_hat, t);
+            double tt = dot(t, t, n);
+            omega = (tt > 0.0) ? dot(t, r, n) / tt : 0.0;
+            for (int i = 0; i < n; i++) {
+                roots[i] += omega * s_hat[i];
+                r[i] -= omega * t[i];
+            }
+            converged = sqrt(dot(r, r, n)) <= SPARSE_TOLERANCE * rhs_norm;
+            breakdown = fabs(omega) < 1e-300;
+        }
+    }
+    return converged;
+}
+
+int sparse_solve(const csr_matrix *matrix, const double *rhs, double *roots, enum sparse_solver solver,
+                 enum sparse_precond precond_kind) {
+    int n = matrix->n;
+    memset(roots, 0, n * sizeof(double));
+
+    double rhs_norm = sqrt(dot(rhs, rhs, n));
+    preconditioner precond;
+    if (!preconditioner_init(&precond, matrix, precond_kind)) {
+        return 0;
+    }
+    if (rhs_norm == 0.0) {
+        preconditioner_free(&precond);
+        return 1;
+    }
+
+    int vectors = (solver == SOLVER_CG) ? 4 : 7;
+    double *work = (double *)malloc((size_t)vectors * n * sizeof(double));
+    int result = 0;
+    if (work != NULL) {
+        if (solver == SOLVER_CG) {
+            result = conjugate_gradient(matrix, &precond, rhs, roots, work, rhs_norm);
+        } else {
+            result = bicgstab(matrix, &precond, rhs, roots, work, rhs_norm);
+        }
+    }
+
+    free(work);
+    preconditioner_free(&precond);
+    return result;
+}
@@ -0,0 +1,41 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#define SPARSE_EPS 1e-9
+#define SPARSE_TOLERANCE 1e-10
+
+enum sparse_solver { SOLVER_CG, SOLVER_BICGSTAB };
+enum sparse_precond { PRECOND_JACOBI, PRECOND_ILU0 };
+
+/*
+    Compressed sparse row storage: the entries of row i are
+    values[row_start[i] .. row_start[i + 1] - 1], sorted by column.
+*/
+typedef struct csr_matrix {
+    int n;
+    int nnz;
+    int *row_start;
+    int *cols;
+    double *values;
+} csr_matrix;
+
+/*
+    input:  "n m nnz" followed by nnz "row col value" triplets (0-based) of the
+            augmented n x (n + 1) matrix; column n holds the right-hand side
+    output: 1 on success, 0 on any format or allocation error
+*/
+int csr_input(csr_matrix *matrix, double **rhs, int *n, int *m);
+int csr_from_triplets(csr_matrix *matrix, int n, int nnz, const int *rows, const int *cols,
+                      const double *values);
+void csr_free(csr_matrix *matrix);
+void csr_multiply(const csr_matrix *matrix, const double *x, double *y);
+
+/*
+    Iterative solve of matrix * roots = rhs. CG expects a symmetric positive
+    definite matrix, BiCGSTAB works for general ones.
+    output: 1 if the relative residual dropped below SPARSE_TOLERANCE
+*/
+int sparse_solve(const csr_matrix *matrix, const double *rhs, double *roots, enum sparse_solver solver,
+                 enum sparse_precond precond);
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_SEED 21
+
+/*
+    Shared by the *_bench programs: a monotonic clock in seconds and the
+    reproducible input they all start from (rand seeded with BENCH_SEED).
+*/
+static inline double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static inline void fill_uniform(double *data, long long n, double low, double high) {
+    srand(BENCH_SEED);
+    for (long long i = 0; i < n; i++) {
+        data[i] = low + (double)rand() / RAND_MAX * (high - low);
+    }
+}
+
+#endif
@@ -1 +1,20 @@
 #include "data_io.h"
+
+#include <stdio.h>
+
+int input(double *data, int n) {
+    int result = 1;
+    for (int i = 0; i < n && result; i++) {
+        result = scanf("%lf", &data[i]) == 1;
+    }
+    return result;
+}
+
+void output(double *data, int n) {
+    for (int i = 0; i < n; i++) {
+        printf("%.2lf", data[i]);
+        if (i < n - 1) {
+            printf(" ");
+        }
+    }
+}
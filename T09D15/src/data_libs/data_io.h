@@ -1,7 +1,12 @@
 #ifndef DATA_IO_H
 #define DATA_IO_H
 
-void input(double *data, int n);
+/*
+    input reads n numbers from stdin, output prints them with two decimals
+    separated by spaces.
+    output: 1 on success, 0 on malformed input
+*/
+int input(double *data, int n);
 void output(double *data, int n);
 
 #endif
@@ -0,0 +1,188 @@
+#ifndef DATA_IO_MACRO_H
+#define DATA_IO_MACRO_H
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DATA_IO_BUFFER (1 << 16)
+#define DATA_IO_TOKEN 64
+#define DATA_IO_FIELD 512
+
+/*
+    Element-wise I/O of an array of any type; format is the scanf/printf
+    conversion of its elements. ok is set to 1 if every element was read.
+*/
+#define INPUT(data, n, format, ok)                       \
+    do {                                                 \
+        (ok) = 1;                                        \
+        for (int io_i = 0; io_i < (n) && (ok); io_i++) { \
+            (ok) = scanf(format, &(data)[io_i]) == 1;    \
+        }                                                \
+    } while (0)
+
+#define OUTPUT(data, n, format)                  \
+    do {                                         \
+        for (int io_i = 0; io_i < (n); io_i++) { \
+            printf(format, (data)[io_i]);        \
+            if (io_i < (n) - 1) {                \
+                printf(" ");                     \
+            }                                    \
+        }                                        \
+    } while (0)
+
+/*
+    Buffered whitespace tokenizer and output buffer shared by every element
+    type. A token longer than DATA_IO_TOKEN - 1 characters is consumed whole
+    but reported as -1, so it fails the read instead of parsing as its prefix;
+    a formatted value takes at most DATA_IO_FIELD - 1 characters.
+*/
+typedef struct data_reader {
+    FILE *file;
+    size_t pos;
+    size_t len;
+    char buffer[DATA_IO_BUFFER];
+} data_reader;
+
+typedef struct data_writer {
+    FILE *file;
+    size_t len;
+    char buffer[DATA_IO_BUFFER];
+} data_writer;
+
+static inline int data_reader_byte(data_reader *reader) {
+    if (reader->pos == reader->len) {
+        reader->len = fread(reader->buffer, 1, DATA_IO_BUFFER, reader->file);
+        reader->pos = 0;
+    }
+    return (reader->pos < reader->len) ? (unsigned char)reader->buffer[reader->pos] : EOF;
+}
+
+static inline int data_reader_token(data_reader *reader, char *token) {
+    int ch = data_reader_byte(reader), len = 0, truncated = 0;
+    while (ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r') {
+        reader->pos++;
+        ch = data_reader_byte(reader);
+    }
+    while (ch != EOF && ch != ' ' && ch != '\n' && ch != '\t' && ch != '\r') {
+        if (len < DATA_IO_TOKEN - 1) {
+            token[len++] = (char)ch;
+        } else {
+            truncated = 1;
+        }
+        reader->pos++;
+        ch = data_reader_byte(reader);
+    }
+    token[len] = '\0';
+    return truncated ? -1 : len;
+}
+
+static inline void data_writer_flush(data_writer *writer) {
+    fwrite(writer->buffer, 1, writer->len, writer->file);
+    writer->len = 0;
+}
+
+/*
+    Defines the typed functions for arrays of type, named <name>_...:
+      <name>_input / <name>_output       stdin / stdout, like data_io.h
+      <name>_read_text / _write_text     buffered bulk text through a FILE
+      <name>_read_binary / _write_binary raw arrays with one fread / fwrite
+      <name>_map_binary / _unmap         read-only mmap of a raw array file
+    parse converts a token (const char *, char **end) like strtod does.
+    Every loop is specialized for type, so no per-element call goes through
+    a format string on the binary paths or a scanf on the text paths.
+*/
+#define DATA_IO_DEFINE(type, name, parse, write_format)                                                      \
+    static inline long long name##_read_text(FILE *file, type *data, long long n) {                          \
+        data_reader *reader = (data_reader *)malloc(sizeof(data_reader));                                    \
+        char token[DATA_IO_TOKEN], *end = token;                                                             \
+        long long count = 0;                                                                                 \
+        int len;                                                                                             \
+        if (reader != NULL) {                                                                                \
+            reader->file = file;                                                                             \
+            reader->pos = reader->len = 0;                                                                   \
+            while (count < n && (len = data_reader_token(reader, token)) != 0) {                             \
+                if (len > 0) {                                                                               \
+                    data[count] = (type)parse(token, &end);                                                  \
+                }                                                                                            \
+                count += (len > 0 && *end == '\0') ? 1 : n + 1;                                              \
+            }                                                                                                \
+            fseek(file, (long)reader->pos - (long)reader->len, SEEK_CUR);                                    \
+            free(reader);                                                                                    \
+        }                                                                                                    \
+        return (count <= n) ? count : -1;                                                                    \
+    }                                                                                                        \
+                                                                                                             \
+    static inline int name##_write_text(FILE *file, const type *data, long long n) {                         \
+        data_writer *writer = (data_writer *)malloc(sizeof(data_writer));                                    \
+        if (writer != NULL) {                                                                                \
+            writer->file = file;                                                                             \
+            writer->len = 0;                                                                                 \
+            for (long long i = 0; i < n; i++) {                                                              \
+                if (writer->len + DATA_IO_FIELD + 1 > DATA_IO_BUFFER) {                                      \
+                    data_writer_flush(writer);                                                               \
+                }                                                                                            \
+                writer->len += snprintf(writer->buffer + writer->len, DATA_IO_FIELD, write_format, data[i]); \
+                writer->buffer[writer->len] = ' ';                                                           \
+                writer->len += (i < n - 1);                                                                  \
+            }                                                                                                \
+            data_writer_flush(writer);                                                                       \
+            free(writer);                                                                                    \
+        }                                                                                                    \
+        return writer != NULL;                                                                               \
+    }                                                                                                        \
+                                                                                                             \
+    static inline int name##_input(type *data, int n) { return name##_read_text(stdin, data, n) == n; }      \
+                                                                                                             \
+    static inline void name##_output(type *data, int n) { name##_write_text(stdout, data, n); }              \
+                                                                                                             \
+    static inline int name##_read_binary(FILE *file, type *data, long long n) {                              \
+        return (long long)fread(data, sizeof(type), (size_t)n, file) == n;                                   \
+    }                                                                                                        \
+                                                                                                             \
+    static inline int name##_write_binary(FILE *file, const type *data, long long n) {                       \
+        return (long long)fwrite(data, sizeof(type), (size_t)n, file) == n;                                  \
+    }                                                                                                        \
+                                                                                                             \
+    static inline const type *name##_map_binary(const char *path, long long *count) {                        \
+        int fd = open(path, O_RDONLY);                                                                       \
+        struct stat info;                                                                                    \
+        void *mapping = MAP_FAILED;                                                                          \
+        if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size >= (off_t)sizeof(type)) {                       \
+            mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);        \
+            *count = (long long)(info.st_size / (off_t)sizeof(type));                                        \
+        }                                                                                                    \
+        if (fd >= 0) {                                                                                       \
+            close(fd);                                                                                       \
+        }                                                                                                    \
+        if (mapping != MAP_FAILED) {                                                                         \
+            madvise(mapping, (size_t)info.st_size, MADV_SEQUENTIAL);                                         \
+        }                                                                                                    \
+        return (mapping != MAP_FAILED) ? (const type *)mapping : NULL;                                       \
+    }                                                                                                        \
+                                                                                                             \
+    static inline void name##_unmap(const type *data, long long count) {                                     \
+        munmap((void *)data, (size_t)count * sizeof(type));                                                  \
+    }
+
+static inline long parse_long(const char *token, char **end) { return strtol(token, end, 10); }
+
+static inline long long parse_long_long(const char *token, char **end) { return strtoll(token, end, 10); }
+
+DATA_IO_DEFINE(double, double, strtod, "%.2lf")
+DATA_IO_DEFINE(float, float, strtof, "%.2f")
+DATA_IO_DEFINE(int, int, parse_long, "%d")
+DATA_IO_DEFINE(long long, long_long, parse_long_long, "%lld")
+
+/*
+    Drop-in replacement of data_io.h.
+*/
+static inline int input(double *data, int n) { return double_input(data, n); }
+
+static inline void output(double *data, int n) { double_output(data, n); }
+
+#endif
@@ -0,0 +1,281 @@
+#include "data_sort.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RADIX_BITS 11
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define RADIX_PASSES 6
+
+typedef struct sort_task {
+    const double *first;
+    long long first_n;
+    const double *second;
+    long long second_n;
+    double *data;
+    double *buffer;
+    long long n;
+    long long from;
+    long long to;
+} sort_task;
+
+unsigned long long key_at(const double *data, long long i) {
+    unsigned long long bits;
+    memcpy(&bits, data + i, sizeof(bits));
+    return bits;
+}
+
+void set_key(double *data, long long i, unsigned long long bits) { memcpy(data + i, &bits, sizeof(bits)); }
+
+/*
+    Flips the sign bit of non-negative values and every bit of negative
+    ones, so the unsigned order of the keys is the numeric order.
+*/
+void to_keys(double *data, long long n) {
+    for (long long i = 0; i < n; i++) {
+        unsigned long long bits = key_at(data, i);
+        set_key(data, i, (bits >> 63) ? ~bits : bits | (1ULL << 63));
+    }
+}
+
+void from_keys(double *data, long long n) {
+    for (long long i = 0; i < n; i++) {
+        unsigned long long bits = key_at(data, i);
+        set_key(data, i, (bits >> 63) ? bits & ~(1ULL << 63) : ~bits);
+    }
+}
+
+void radix_sort(double *data, double *buffer, long long n) {
+    long long counts[RADIX_PASSES][RADIX_SIZE] = {{0}};
+    to_keys(data, n);
+    for (long long i = 0; i < n; i++) {
+        unsigned long long key = key_at(data, i);
+        for (int pass = 0; pass < RADIX_PASSES; pass++) {
+            counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+        }
+    }
+
+    double *source = data, *target = buffer;
+    for (int pass = 0; pass < RADIX_PASSES && n > 0; pass++) {
+        int shift = pass * RADIX_BITS;
+        long long *count = counts[pass];
+        if (count[(key_at(source, 0) >> shift) & (RADIX_SIZE - 1)] == n) {
+            continue;
+        }
+        long long offset = 0;
+        for (int digit = 0; digit < RADIX_SIZE; digit++) {
+            long long size = count[digit];
+            count[digit] = offset;
+            offset += size;
+        }
+        for (long long i = 0; i < n; i++) {
+            target[count[(key_at(source, i) >> shift) & (RADIX_SIZE - 1)]++] = source[i];
+        }
+        double *temp = source;
+        source = target;
+        target = temp;
+    }
+    if (source != data) {
+        memcpy(data, source, n * sizeof(double));
+    }
+    from_keys(data, n);
+}
+
+void insertion_sort(double *data, long long n) {
+    for (long long i = 1; i < n; i++) {
+        double value = data[i];
+        long long j = i;
+        while (j > 0 && data[j - 1] > value) {
+            data[j] = data[j - 1];
+            j--;
+        }
+        data[j] = value;
+    }
+}
+
+/*
+    Stable merge: on ties the element of first comes out first.
+*/
+void merge(const double *first, long long first_n, const double *second, long long second_n, double *result) {
+    long long i = 0, j = 0, k = 0;
+    while (i < first_n && j < second_n) {
+        result[k++] = (second[j] < first[i]) ? second[j++] : first[i++];
+    }
+    memcpy(result + k, first + i, (first_n - i) * sizeof(double));
+    memcpy(result + k + first_n - i, second + j, (second_n - j) * sizeof(double));
+}
+
+/*
+    Bottom-up: insertion-sorted runs of SORT_INSERTION_CUTOFF, then merge
+    passes that alternate between data and buffer.
+*/
+void merge_sort(double *data, double *buffer, long long n) {
+    for (long long start = 0; start < n; start += SORT_INSERTION_CUTOFF) {
+        insertion_sort(data + start, (n - start < SORT_INSERTION_CUTOFF) ? n - start : SORT_INSERTION_CUTOFF);
+    }
+    double *source = data, *target = buffer;
+    for (long long width = SORT_INSERTION_CUTOFF; width < n; width *= 2) {
+        for (long long start = 0; start < n; start += 2 * width) {
+            long long middle = (start + width < n) ? start + width : n;
+            long long end = (start + 2 * width < n) ? start + 2 * width : n;
+            merge(source + start, middle - start, source + middle, end - middle, target + start);
+        }
+        double *temp = source;
+        source = target;
+        target = temp;
+    }
+    if (source != data) {
+        memcpy(data, source, n * sizeof(double));
+    }
+}
+
+void sort_serial(double *data, double *buffer, long long n) {
+    if (n < SORT_RADIX_MIN) {
+        merge_sort(data, buffer, n);
+    } else {
+        radix_sort(data, buffer, n);
+    }
+}
+
+/*
+    Number of elements taken from first among the first i outputs of the
+    stable merge of first and second.
+*/
+long long co_rank(long long i, const double *first, long long first_n, const double *second,
+                  long long second_n) {
+    long long low = (i > second_n) ? i - second_n : 0;
+    long long high = (i < first_n) ? i : first_n;
+    while (low < high) {
+        long long j = low + (high - low) / 2;
+        if (first[j] <= second[i - j - 1]) {
+            low = j + 1;
+        } else {
+            high = j;
+        }
+    }
+    return low;
+}
+
+void *slice_main(void *arg) {
+    sort_task *task = (sort_task *)arg;
+    sort_serial(task->data, task->buffer, task->n);
+    return NULL;
+}
+
+void *merge_main(void *arg) {
+    const sort_task *task = (const sort_task *)arg;
+    long long start = co_rank(task->from, task->first, task->first_n, task->second, task->second_n);
+    long long end = co_rank(task->to, task->first, task->first_n, task->second, task->second_n);
+    long long second_count = task->to - task->from - (end - start);
+    merge(task->first + start, end - start, task->second + task->from - start, second_count,
+          task->data + task->from);
+    return NULL;
+}
+
+/*
+    Runs tasks[1 .. count - 1] on new threads and tasks[0] on the caller;
+    a task whose thread cannot be created runs on the caller as well.
+*/
+void run_tasks(void *(*body)(void *), sort_task *tasks, int count) {
+    pthread_t threads[SORT_MAX_THREADS];
+    int started[SORT_MAX_THREADS];
+    for (int i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, body, &tasks[i]) == 0;
+        if (!started[i]) {
+            body(&tasks[i]);
+        }
+    }
+    body(&tasks[0]);
+    for (int i = 1; i < count; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+/*
+    One round halves the number of sorted runs described by bounds. Each
+    pair is merged by threads / pairs tasks that split its output evenly.
+    output: the new number of runs
+*/
+int merge_round(const double *source, double *target, long long *bounds, int runs, int threads) {
+    sort_task tasks[SORT_MAX_THREADS];
+    int pairs = (runs + 1) / 2, count = 0;
+    int per_pair = (threads / pairs > 1) ? threads / pairs : 1;
+
+    for (int p = 0; p < pairs; p++) {
+        long long begin = bounds[2 * p], middle = bounds[(2 * p + 1 < runs) ? 2 * p + 1 : runs];
+        long long end = bounds[(2 * p + 2 < runs) ? 2 * p + 2 : runs], total = end - begin;
+        for (int part = 0; part < per_pair; part++) {
+            sort_task task = {source + begin, middle - begin, source + middle, end - middle, target + begin,
+                              NULL, 0, total * part / per_pair, total * (part + 1) / per_pair};
+            tasks[count++] = task;
+        }
+        bounds[p] = begin;
+    }
+    bounds[pairs] = bounds[runs];
+    run_tasks(merge_main, tasks, count);
+    return pairs;
+}
+
+void sort_parallel(double *data, double *buffer, long long n, int threads) {
+    sort_task tasks[SORT_MAX_THREADS];
+    long long bounds[SORT_MAX_THREADS + 1];
+    for (int i = 0; i <= threads; i++) {
+        bounds[i] = n * i / threads;
+    }
+    for (int i = 0; i < threads; i++) {
+        sort_task task = {NULL, 0, NULL, 0, data + bounds[i], buffer + bounds[i], bounds[i + 1] - bounds[i],
+                          0, 0};
+        tasks[i] = task;
+    }
+    run_tasks(slice_main, tasks, threads);
+
+    double *source = data, *target = buffer;
+    int runs = threads;
+    while (runs > 1) {
+        runs = merge_round(source, target, bounds, runs, threads);
+        double *temp = source;
+        source = target;
+        target = temp;
+    }
+    if (source != data) {
+        memcpy(data, source, n * sizeof(double));
+    }
+}
+
+int compare_values_qsort(const void *first, const void *second) {
+    double a = *(const double *)first, b = *(const double *)second;
+    return (a > b) - (a < b);
+}
+
+int sort_with(double *data, long long n, int threads) {
+    if (threads <= 0) {
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    threads = (threads > SORT_MAX_THREADS) ? SORT_MAX_THREADS : (threads < 1 ? 1 : threads);
+    if (n < SORT_PARALLEL_MIN) {
+        threads = 1;
+    }
+
+    int result = 1;
+    if (n <= SORT_INSERTION_CUTOFF) {
+        insertion_sort(data, n);
+    } else {
+        double *buffer = (double *)malloc(n * sizeof(double));
+        result = buffer != NULL;
+        if (!result) {
+            qsort(data, n, sizeof(double), compare_values_qsort);
+        } else if (threads == 1) {
+            sort_serial(data, buffer, n);
+        } else {
+            sort_parallel(data, buffer, n, threads);
+        }
+        free(buffer);
+    }
+    return result;
+}
+
+void sort(double *data, int n) { sort_with(data, n, 0); }
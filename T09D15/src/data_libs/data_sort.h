@@ -0,0 +1,31 @@
+#ifndef DATA_SORT_H
+#define DATA_SORT_H
+
+#define SORT_INSERTION_CUTOFF 32
+#define SORT_RADIX_MIN (1 << 12)
+#define SORT_PARALLEL_MIN (1 << 18)
+#define SORT_MAX_THREADS 64
+
+/*
+    Ascending sort of doubles with the strategy picked by size: insertion
+    sort below SORT_INSERTION_CUTOFF, merge sort below SORT_RADIX_MIN, LSD
+    radix sort above, and above SORT_PARALLEL_MIN one slice per online CPU
+    sorted in its own thread followed by parallel merge rounds.
+    -0.0 and 0.0 may come out in either order; data must not contain NaNs.
+*/
+void sort(double *data, int n);
+
+/*
+    The same with an explicit thread count (<= 0 means one per online CPU).
+    output: 0 if the scratch buffer could not be allocated; data is then
+            sorted in place with qsort
+*/
+int sort_with(double *data, long long n, int threads);
+
+/*
+    Serial kernels; buffer must hold n values.
+*/
+void merge_sort(double *data, double *buffer, long long n);
+void radix_sort(double *data, double *buffer, long long n);
+
+#endif
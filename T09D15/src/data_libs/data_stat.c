@@ -1 +1,277 @@
 #include "data_stat.h"
+
+#include <math.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define STAT_LEVELS 64
+
+/*
+    fmin/fmax are library calls at -O2 because of their NaN rules; data
+    must not contain NaNs anyway, and these compile to minsd/maxsd.
+*/
+static inline double stat_min(double a, double b) { return (b < a) ? b : a; }
+
+static inline double stat_max(double a, double b) { return (b > a) ? b : a; }
+
+#if defined(__AVX2__)
+/*
+    Extremes and sum of a block, 8 values per iteration in two AVX2 lanes.
+*/
+double block_scan(const double *data, int n, double *lo, double *hi) {
+    __m256d low = _mm256_set1_pd(data[0]), high = low;
+    __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d a = _mm256_loadu_pd(data + i), b = _mm256_loadu_pd(data + i + 4);
+        low = _mm256_min_pd(low, _mm256_min_pd(a, b));
+        high = _mm256_max_pd(high, _mm256_max_pd(a, b));
+        sum0 = _mm256_add_pd(sum0, a);
+        sum1 = _mm256_add_pd(sum1, b);
+    }
+    double lows[4], highs[4], sums[4];
+    _mm256_storeu_pd(lows, low);
+    _mm256_storeu_pd(highs, high);
+    _mm256_storeu_pd(sums, _mm256_add_pd(sum0, sum1));
+    *lo = stat_min(stat_min(lows[0], lows[1]), stat_min(lows[2], lows[3]));
+    *hi = stat_max(stat_max(highs[0], highs[1]), stat_max(highs[2], highs[3]));
+    double sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    for (; i < n; i++) {
+        *lo = stat_min(*lo, data[i]);
+        *hi = stat_max(*hi, data[i]);
+        sum += data[i];
+    }
+    return sum;
+}
+
+double block_m2(const double *data, int n, double center) {
+    __m256d c = _mm256_set1_pd(center);
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d a = _mm256_sub_pd(_mm256_loadu_pd(data + i), c);
+        __m256d b = _mm256_sub_pd(_mm256_loadu_pd(data + i + 4), c);
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(a, a));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(b, b));
+    }
+    double sums[4];
+    _mm256_storeu_pd(sums, _mm256_add_pd(acc0, acc1));
+    double m2 = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    for (; i < n; i++) {
+        m2 += (data[i] - center) * (data[i] - center);
+    }
+    return m2;
+}
+
+void extremes(const double *data, long long n, double *lo, double *hi) {
+    if (n > 0) {
+        __m256d low0 = _mm256_set1_pd(data[0]), low1 = low0, high0 = low0, high1 = low0;
+        long long i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256d a = _mm256_loadu_pd(data + i), b = _mm256_loadu_pd(data + i + 4);
+            low0 = _mm256_min_pd(low0, a);
+            low1 = _mm256_min_pd(low1, b);
+            high0 = _mm256_max_pd(high0, a);
+            high1 = _mm256_max_pd(high1, b);
+        }
+        double lows[4], highs[4];
+        _mm256_storeu_pd(lows, _mm256_min_pd(low0, low1));
+        _mm256_storeu_pd(highs, _mm256_max_pd(high0, high1));
+        *lo = stat_min(stat_min(lows[0], lows[1]), stat_min(lows[2], lows[3]));
+        *hi = stat_max(stat_max(highs[0], highs[1]), stat_max(highs[2], highs[3]));
+        for (; i < n; i++) {
+            *lo = stat_min(*lo, data[i]);
+            *hi = stat_max(*hi, data[i]);
+        }
+    }
+}
+#elif defined(__SSE2__)
+double block_scan(const double *data, int n, double *lo, double *hi) {
+    __m128d low = _mm_set1_pd(data[0]), high = low;
+    __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d a = _mm_loadu_pd(data + i), b = _mm_loadu_pd(data + i + 2);
+        low = _mm_min_pd(low, _mm_min_pd(a, b));
+        high = _mm_max_pd(high, _mm_max_pd(a, b));
+        sum0 = _mm_add_pd(sum0, a);
+        sum1 = _mm_add_pd(sum1, b);
+    }
+    double lows[2], highs[2], sums[2];
+    _mm_storeu_pd(lows, low);
+    _mm_storeu_pd(highs, high);
+    _mm_storeu_pd(sums, _mm_add_pd(sum0, sum1));
+    *lo = stat_min(lows[0], lows[1]);
+    *hi = stat_max(highs[0], highs[1]);
+    double sum = sums[0] + sums[1];
+    for (; i < n; i++) {
+        *lo = stat_min(*lo, data[i]);
+        *hi = stat_max(*hi, data[i]);
+        sum += data[i];
+    }
+    return sum;
+}
+
+double block_m2(const double *data, int n, double center) {
+    __m128d c = _mm_set1_pd(center);
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d a = _mm_sub_pd(_mm_loadu_pd(data + i), c);
+        __m128d b = _mm_sub_pd(_mm_loadu_pd(data + i + 2), c);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(a, a));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(b, b));
+    }
+    double sums[2];
+    _mm_storeu_pd(sums, _mm_add_pd(acc0, acc1));
+    double m2 = sums[0] + sums[1];
+    for (; i < n; i++) {
+        m2 += (data[i] - center) * (data[i] - center);
+    }
+    return m2;
+}
+
+void extremes(const double *data, long long n, double *lo, double *hi) {
+    if (n > 0) {
+        __m128d low0 = _mm_set1_pd(data[0]), low1 = low0, high0 = low0, high1 = low0;
+        long long i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128d a = _mm_loadu_pd(data + i), b = _mm_loadu_pd(data + i + 2);
+            low0 = _mm_min_pd(low0, a);
+            low1 = _mm_min_pd(low1, b);
+            high0 = _mm_max_pd(high0, a);
+            high1 = _mm_max_pd(high1, b);
+        }
+        double lows[2], highs[2];
+        _mm_storeu_pd(lows, _mm_min_pd(low0, low1));
+        _mm_storeu_pd(highs, _mm_max_pd(high0, high1));
+        *lo = stat_min(lows[0], lows[1]);
+        *hi = stat_max(highs[0], highs[1]);
+        for (; i < n; i++) {
+            *lo = stat_min(*lo, data[i]);
+            *hi = stat_max(*hi, data[i]);
+        }
+    }
+}
+#else
+double block_scan(const double *data, int n, double *lo, double *hi) {
+    double sum = 0;
+    *lo = data[0];
+    *hi = data[0];
+    for (int i = 0; i < n; i++) {
+        *lo = (data[i] < *lo) ? data[i] : *lo;
+        *hi = (data[i] > *hi) ? data[i] : *hi;
+        sum += data[i];
+    }
+    return sum;
+}
+
+double block_m2(const double *data, int n, double center) {
+    double m2 = 0;
+    for (int i = 0; i < n; i++) {
+        m2 += (data[i] - center) * (data[i] - center);
+    }
+    return m2;
+}
+
+void extremes(const double *data, long long n, double *lo, double *hi) {
+    if (n > 0) {
+        *lo = data[0];
+        *hi = data[0];
+        for (long long i = 1; i < n; i++) {
+            *lo = (data[i] < *lo) ? data[i] : *lo;
+            *hi = (data[i] > *hi) ? data[i] : *hi;
+        }
+    }
+}
+#endif
+
+/*
+    The second loop reads the block back from L1, so memory sees one pass.
+*/
+data_summary block_summary(const double *data, int n) {
+    data_summary stats;
+    stats.n = n;
+    stats.mean = block_scan(data, n, &stats.min, &stats.max) / n;
+    stats.m2 = block_m2(data, n, stats.mean);
+    return stats;
+}
+
+void summary_init(data_summary *stats) {
+    stats->n = 0;
+    stats->min = INFINITY;
+    stats->max = -INFINITY;
+    stats->mean = 0;
+    stats->m2 = 0;
+}
+
+void summary_merge(data_summary *stats, const data_summary *other) {
+    if (stats->n == 0) {
+        *stats = *other;
+    } else if (other->n > 0) {
+        double n = (double)(stats->n + other->n);
+        double delta = other->mean - stats->mean;
+        stats->mean += delta * (double)other->n / n;
+        stats->m2 += other->m2 + delta * delta * (double)stats->n * (double)other->n / n;
+        stats->min = fmin(stats->min, other->min);
+        stats->max = fmax(stats->max, other->max);
+        stats->n += other->n;
+    }
+}
+
+/*
+    Blocks are merged like a binary counter, so partial results of equal
+    size are combined first and rounding error grows with log(n).
+*/
+void summary_add(data_summary *stats, const double *data, long long n) {
+    data_summary stack[STAT_LEVELS];
+    int level[STAT_LEVELS];
+    int depth = 0;
+
+    for (long long start = 0; start < n; start += STAT_BLOCK) {
+        int len = (n - start < STAT_BLOCK) ? (int)(n - start) : STAT_BLOCK;
+        stack[depth] = block_summary(data + start, len);
+        level[depth++] = 0;
+        while (depth > 1 && level[depth - 1] == level[depth - 2]) {
+            summary_merge(&stack[depth - 2], &stack[depth - 1]);
+            level[depth - 2]++;
+            depth--;
+        }
+    }
+    while (depth > 1) {
+        summary_merge(&stack[depth - 2], &stack[depth - 1]);
+        depth--;
+    }
+    if (depth == 1) {
+        summary_merge(stats, &stack[0]);
+    }
+}
+
+double summary_variance(const data_summary *stats) { return (stats->n > 0) ? stats->m2 / stats->n : 0; }
+
+/*
+    A series that fits in one block skips the merge stack.
+*/
+data_summary summary(const double *data, long long n) {
+    data_summary stats;
+    if (n > 0 && n <= STAT_BLOCK) {
+        stats = block_summary(data, (int)n);
+    } else {
+        summary_init(&stats);
+        summary_add(&stats, data, n);
+    }
+    return stats;
+}
+
+double max(double *data, int n) { return summary(data, n).max; }
+
+double min(double *data, int n) { return summary(data, n).min; }
+
+double mean(double *data, int n) { return summary(data, n).mean; }
+
+double variance(double *data, int n) {
+    data_summary stats = summary(data, n);
+    return summary_variance(&stats);
+}
@@ -1,9 +1,47 @@
 #ifndef DATA_STAT_H
 #define DATA_STAT_H
 
+#define STAT_BLOCK 1024
+
+/*
+    Count, extremes, mean and sum of squared deviations (m2) of a series.
+    variance = m2 / n (population variance).
+*/
+typedef struct data_summary {
+    long long n;
+    double min;
+    double max;
+    double mean;
+    double m2;
+} data_summary;
+
 double max(double *data, int n);
 double min(double *data, int n);
 double mean(double *data, int n);
 double variance(double *data, int n);
 
+/*
+    All four statistics in one pass over memory. Each block of STAT_BLOCK
+    values is reduced with SIMD while it is still in L1 (min, max, sum, then
+    squared deviations from the block mean), and the blocks are combined
+    pairwise with the Chan/Welford update.
+*/
+data_summary summary(const double *data, long long n);
+
+/*
+    Minimum and maximum only, in one SIMD pass with independent accumulators,
+    for callers that do not need the moments. Leaves lo/hi untouched if n <= 0.
+*/
+void extremes(const double *data, long long n, double *lo, double *hi);
+
+/*
+    Incremental form for data that arrives in chunks: summary_add folds a chunk
+    into an accumulator started with summary_init, summary_merge combines two
+    accumulators.
+*/
+void summary_init(data_summary *stats);
+void summary_add(data_summary *stats, const double *data, long long n);
+void summary_merge(data_summary *stats, const data_summary *other);
+double summary_variance(const data_summary *stats);
+
 #endif
@@ -0,0 +1,228 @@
+#include "external_sort.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "data_sort.h"
+
+typedef struct run_reader {
+    FILE *file;
+    long long offset;
+    long long left;
+    double *buffer;
+    long long len;
+    long long pos;
+} run_reader;
+
+int sorter_init(external_sorter *sorter, long long capacity) {
+    sorter->capacity = (capacity < 4 * RUN_BUFFER_MIN) ? 4 * RUN_BUFFER_MIN : capacity;
+    sorter->count = 0;
+    sorter->file = NULL;
+    sorter->file_len = 0;
+    sorter->runs = NULL;
+    sorter->run_count = 0;
+    sorter->run_capacity = 0;
+    sorter->chunk = (double *)malloc(sorter->capacity * sizeof(double));
+    return sorter->chunk != NULL;
+}
+
+void sorter_free(external_sorter *sorter) {
+    if (sorter->file != NULL) {
+        fclose(sorter->file);
+    }
+    free(sorter->runs);
+    free(sorter->chunk);
+    sorter->file = NULL;
+    sorter->runs = NULL;
+    sorter->chunk = NULL;
+    sorter->run_count = 0;
+}
+
+int add_run(external_sorter *sorter, long long offset, long long len) {
+    int result = 1;
+    if (sorter->run_count == sorter->run_capacity) {
+        int capacity = sorter->run_capacity ? sorter->run_capacity * 2 : 16;
+        sorted_run *runs = (sorted_run *)realloc(sorter->runs, capacity * sizeof(sorted_run));
+        result = runs != NULL;
+        if (result) {
+            sorter->runs = runs;
+            sorter->run_capacity = capacity;
+        }
+    }
+    if (result) {
+        sorted_run run = {offset, len};
+        sorter->runs[sorter->run_count++] = run;
+    }
+    return result;
+}
+
+/*
+    Appends values at the end of the run file, offsets count values.
+*/
+int append_values(external_sorter *sorter, const double *values, long long n) {
+    int result = fseek(sorter->file, (long)(sorter->file_len * sizeof(double)), SEEK_SET) == 0 &&
+                 (long long)fwrite(values, sizeof(double), n, sorter->file) == n;
+    sorter->file_len += result ? n : 0;
+    return result;
+}
+
+int spill(external_sorter *sorter) {
+    sort_with(sorter->chunk, sorter->count, 0);
+    if (sorter->file == NULL) {
+        sorter->file = tmpfile();
+    }
+    long long offset = sorter->file_len;
+    int result = sorter->file != NULL && append_values(sorter, sorter->chunk, sorter->count) &&
+                 add_run(sorter, offset, sorter->count);
+    sorter->count = 0;
+    return result;
+}
+
+int sorter_push(external_sorter *sorter, const double *data, long long n) {
+    int result = 1;
+    while (n > 0 && result) {
+        long long space = sorter->capacity - sorter->count;
+        long long take = (n < space) ? n : space;
+        memcpy(sorter->chunk + sorter->count, data, take * sizeof(double));
+        sorter->count += take;
+        data += take;
+        n -= take;
+        if (sorter->count == sorter->capacity) {
+            result = spill(sorter);
+        }
+    }
+    return result;
+}
+
+/*
+    The readers share one FILE, so every refill seeks to its own run first.
+*/
+void refill(run_reader *reader, long long size) {
+    long long want = (reader->left < size) ? reader->left : size;
+    reader->len = 0;
+    if (want > 0 && fseek(reader->file, (long)(reader->offset * sizeof(double)), SEEK_SET) == 0) {
+        reader->len = (long long)fread(reader->buffer, sizeof(double), want, reader->file);
+    }
+    reader->offset += reader->len;
+    reader->left -= reader->len;
+    reader->pos = 0;
+}
+
+double head(const run_reader *readers, int index) { return readers[index].buffer[readers[index].pos]; }
+
+void sift_down(int *heap, int size, int i, const run_reader *readers) {
+    int done = 0;
+    while (!done) {
+        int smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+        if (left < size && head(readers, heap[left]) < head(readers, heap[smallest])) {
+            smallest = left;
+        }
+        if (right < size && head(readers, heap[right]) < head(readers, heap[smallest])) {
+            smallest = right;
+        }
+        done = smallest == i;
+        if (!done) {
+            int temp = heap[i];
+            heap[i] = heap[smallest];
+            heap[smallest] = temp;
+            i = smallest;
+        }
+    }
+}
+
+/*
+    Merges runs[0 .. k - 1] through the chunk: k reader buffers and one output
+    buffer of capacity / (k + 1) values each. Sift-down from every position
+    in reverse builds the initial heap.
+*/
+int merge_runs(external_sorter *sorter, const sorted_run *runs, int k, sort_sink sink, void *context) {
+    long long size = sorter->capacity / (k + 1);
+    run_reader *readers = (run_reader *)malloc(k * sizeof(run_reader));
+    int *heap = (int *)malloc(k * sizeof(int));
+    int result = readers != NULL && heap != NULL, count = 0;
+    double *out = sorter->chunk + (long long)k * size;
+    long long out_len = 0;
+
+    for (int i = 0; i < k && result; i++) {
+        double *buffer = sorter->chunk + (long long)i * size;
+        run_reader reader = {sorter->file, runs[i].offset, runs[i].len, buffer, 0, 0};
+        readers[i] = reader;
+        refill(&readers[i], size);
+        if (readers[i].len > 0) {
+            heap[count++] = i;
+        }
+    }
+    for (int i = count / 2 - 1; i >= 0 && result; i--) {
+        sift_down(heap, count, i, readers);
+    }
+    while (count > 0 && result) {
+        run_reader *reader = &readers[heap[0]];
+        out[out_len++] = reader->buffer[reader->pos++];
+        if (out_len == size) {
+            sink(context, out, out_len);
+            out_len = 0;
+        }
+        if (reader->pos == reader->len) {
+            refill(reader, size);
+        }
+        if (reader->len == 0) {
+            result = reader->left == 0;
+            heap[0] = heap[--count];
+        }
+        sift_down(heap, count, 0, readers);
+    }
+    if (result && out_len > 0) {
+        sink(context, out, out_len);
+    }
+
+    free(readers);
+    free(heap);
+    return result;
+}
+
+typedef struct append_context {
+    external_sorter *sorter;
+    int result;
+} append_context;
+
+void append_sink(void *context, const double *values, long long n) {
+    append_context *append = (append_context *)context;
+    append->result = append_values(append->sorter, values, n) && append->result;
+}
+
+/*
+    Merges the oldest fan_in runs into one new run at the end of the file and
+    of the list. The space of the merged runs is not reused.
+*/
+int merge_pass(external_sorter *sorter, int fan_in) {
+    long long offset = sorter->file_len;
+    append_context append = {sorter, 1};
+    int result = merge_runs(sorter, sorter->runs, fan_in, append_sink, &append) && append.result;
+    if (result) {
+        sorter->run_count -= fan_in;
+        memmove(sorter->runs, sorter->runs + fan_in, sorter->run_count * sizeof(sorted_run));
+        result = add_run(sorter, offset, sorter->file_len - offset);
+    }
+    return result;
+}
+
+int sorter_finish(external_sorter *sorter, sort_sink sink, void *context) {
+    int result = 1;
+    if (sorter->run_count == 0) {
+        sort_with(sorter->chunk, sorter->count, 0);
+        sink(context, sorter->chunk, sorter->count);
+        sorter->count = 0;
+    } else {
+        int fan_in = (int)(sorter->capacity / RUN_BUFFER_MIN) - 1;
+        result = sorter->count == 0 || spill(sorter);
+        while (result && sorter->run_count > fan_in) {
+            result = merge_pass(sorter, fan_in);
+        }
+        result = result && merge_runs(sorter, sorter->runs, sorter->run_count, sink, context);
+        fclose(sorter->file);
+        sorter->file = NULL;
+        sorter->file_len = 0;
+        sorter->run_count = 0;
+    }
+    return result;
+}
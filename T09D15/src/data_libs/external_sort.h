@@ -0,0 +1,50 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <stdio.h>
+
+#define RUN_BUFFER_MIN 512
+
+typedef void (*sort_sink)(void *context, const double *values, long long n);
+
+/*
+    Sorts a stream of doubles that may not fit in memory. Values are
+    collected into a chunk of capacity values; every full chunk is sorted
+    with sort_with (data_sort) and appended as a run to a single anonymous
+    temporary file, so the number of runs is not limited by open files.
+    The runs are then merged with a heap, fan-in capacity / RUN_BUFFER_MIN - 1,
+    in as many passes as needed; a pass appends its output to the same file.
+    Memory stays at capacity values (at least 4 * RUN_BUFFER_MIN), plus as
+    many again for the scratch buffer of sort_with while a chunk is sorted.
+*/
+typedef struct sorted_run {
+    long long offset;
+    long long len;
+} sorted_run;
+
+typedef struct external_sorter {
+    double *chunk;
+    long long capacity;
+    long long count;
+    FILE *file;
+    long long file_len;
+    sorted_run *runs;
+    int run_count;
+    int run_capacity;
+} external_sorter;
+
+/*
+    output: 1 on success, 0 on allocation or temporary file errors
+*/
+int sorter_init(external_sorter *sorter, long long capacity);
+int sorter_push(external_sorter *sorter, const double *data, long long n);
+
+/*
+    Hands the sorted values to sink in ascending order, in batches, and
+    releases the runs. When everything fitted in one chunk nothing touches
+    the disk.
+*/
+int sorter_finish(external_sorter *sorter, sort_sink sink, void *context);
+void sorter_free(external_sorter *sorter);
+
+#endif
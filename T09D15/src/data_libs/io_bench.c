@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "data_io_macro.h"
+
+#define BENCH_COUNT 10000000
+#define BINARY_COUNT 100000000LL
+
+void fill(double *data, long long n) {
+    srand(BENCH_SEED);
+    for (long long i = 0; i < n; i++) {
+        data[i] = (double)(rand() % 2000000 - 1000000) / 100;
+    }
+}
+
+/*
+    Text: the printf / scanf loops of data_io.c against the buffered writer
+    and reader on the same file of BENCH_COUNT values with two decimals.
+*/
+void bench_text(double *expected, double *data) {
+    FILE *file = tmpfile();
+    double start = now_seconds();
+    double_write_text(file, expected, BENCH_COUNT);
+    printf("%d values as text\nwrite_text:  %7.1f ms\n", BENCH_COUNT, (now_seconds() - start) * 1e3);
+
+    FILE *baseline = tmpfile();
+    start = now_seconds();
+    for (int i = 0; baseline != NULL && i < BENCH_COUNT; i++) {
+        fprintf(baseline, (i < BENCH_COUNT - 1) ? "%.2lf " : "%.2lf", expected[i]);
+    }
+    printf("fprintf:     %7.1f ms\n", (now_seconds() - start) * 1e3);
+    if (baseline != NULL) {
+        fclose(baseline);
+    }
+
+    rewind(file);
+    start = now_seconds();
+    int ok = 1;
+    for (int i = 0; i < BENCH_COUNT && ok; i++) {
+        ok = fscanf(file, "%lf", &data[i]) == 1;
+    }
+    printf("fscanf:      %7.1f ms [%s]\n", (now_seconds() - start) * 1e3,
+           ok && !memcmp(data, expected, BENCH_COUNT * sizeof(double)) ? "ok" : "MISMATCH");
+
+    rewind(file);
+    memset(data, 0, BENCH_COUNT * sizeof(double));
+    start = now_seconds();
+    ok = double_read_text(file, data, BENCH_COUNT) == BENCH_COUNT;
+    printf("read_text:   %7.1f ms [%s]\n", (now_seconds() - start) * 1e3,
+           ok && !memcmp(data, expected, BENCH_COUNT * sizeof(double)) ? "ok" : "MISMATCH");
+    fclose(file);
+}
+
+void report_binary(const char *name, double seconds, int ok) {
+    printf("%s %7.1f ms %6.0f MB/s [%s]\n", name, seconds * 1e3,
+           BINARY_COUNT * sizeof(double) / seconds / 1e6, ok ? "ok" : "MISMATCH");
+}
+
+/*
+    Binary: BINARY_COUNT raw values through fwrite, fread and mmap; the
+    mapped array is summed so every page is actually touched.
+*/
+void bench_binary(double *expected, double *data, const char *path) {
+    FILE *file = fopen(path, "wb");
+    double start = now_seconds();
+    int ok = file != NULL && double_write_binary(file, expected, BINARY_COUNT);
+    if (file != NULL) {
+        ok = fclose(file) == 0 && ok;
+    }
+    printf("%lld values as binary\n", BINARY_COUNT);
+    report_binary("write_binary:", now_seconds() - start, ok);
+
+    file = fopen(path, "rb");
+    start = now_seconds();
+    ok = file != NULL && double_read_binary(file, data, BINARY_COUNT);
+    report_binary("read_binary: ", now_seconds() - start,
+                  ok && !memcmp(data, expected, BINARY_COUNT * sizeof(double)));
+    if (file != NULL) {
+        fclose(file);
+    }
+
+    double sum = 0, check = 0;
+    for (long long i = 0; i < BINARY_COUNT; i++) {
+        check += expected[i];
+    }
+    long long count = 0;
+    start = now_seconds();
+    const double *mapped = double_map_binary(path, &count);
+    for (long long i = 0; mapped != NULL && i < count; i++) {
+        sum += mapped[i];
+    }
+    report_binary("map_binary:  ", now_seconds() - start,
+                  mapped != NULL && count == BINARY_COUNT && sum == check);
+    if (mapped != NULL) {
+        double_unmap(mapped, count);
+    }
+}
+
+int main(void) {
+    double *expected = (double *)malloc(BINARY_COUNT * sizeof(double));
+    double *data = (double *)malloc(BINARY_COUNT * sizeof(double));
+    char path[] = "/tmp/io_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (expected == NULL || data == NULL || fd < 0) {
+        printf("n/a");
+    } else {
+        close(fd);
+        fill(expected, BINARY_COUNT);
+        bench_text(expected, data);
+        bench_binary(expected, data, path);
+        unlink(path);
+    }
+    free(expected);
+    free(data);
+    return 0;
+}
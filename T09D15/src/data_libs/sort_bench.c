@@ -0,0 +1,63 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "data_sort.h"
+
+#define BENCH_COUNT 10000000
+#define THREAD_STEPS 4
+
+int compare_doubles(const void *first, const void *second) {
+    double a = *(const double *)first, b = *(const double *)second;
+    return (a > b) - (a < b);
+}
+
+void fill(double *data, int n) {
+    srand(BENCH_SEED);
+    for (int i = 0; i < n; i++) {
+        data[i] = ((double)rand() / RAND_MAX - 0.3) * pow(10, rand() % 7 - 3);
+    }
+}
+
+int main(void) {
+    double *expected = (double *)malloc(BENCH_COUNT * sizeof(double));
+    double *data = (double *)malloc(BENCH_COUNT * sizeof(double));
+    double *buffer = (double *)malloc(BENCH_COUNT * sizeof(double));
+    int threads[THREAD_STEPS] = {1, 2, 4, 8};
+    if (expected == NULL || data == NULL || buffer == NULL) {
+        printf("n/a");
+        return 0;
+    }
+
+    fill(expected, BENCH_COUNT);
+    double start = now_seconds();
+    qsort(expected, BENCH_COUNT, sizeof(double), compare_doubles);
+    printf("%d doubles\nqsort:            %7.1f ms\n", BENCH_COUNT, (now_seconds() - start) * 1e3);
+
+    fill(data, BENCH_COUNT);
+    start = now_seconds();
+    merge_sort(data, buffer, BENCH_COUNT);
+    printf("merge_sort:       %7.1f ms [%s]\n", (now_seconds() - start) * 1e3,
+           memcmp(data, expected, BENCH_COUNT * sizeof(double)) ? "MISMATCH" : "ok");
+
+    fill(data, BENCH_COUNT);
+    start = now_seconds();
+    radix_sort(data, buffer, BENCH_COUNT);
+    printf("radix_sort:       %7.1f ms [%s]\n", (now_seconds() - start) * 1e3,
+           memcmp(data, expected, BENCH_COUNT * sizeof(double)) ? "MISMATCH" : "ok");
+
+    for (int i = 0; i < THREAD_STEPS; i++) {
+        fill(data, BENCH_COUNT);
+        start = now_seconds();
+        sort_with(data, BENCH_COUNT, threads[i]);
+        printf("sort_with(%d):     %7.1f ms [%s]\n", threads[i], (now_seconds() - start) * 1e3,
+               memcmp(data, expected, BENCH_COUNT * sizeof(double)) ? "MISMATCH" : "ok");
+    }
+
+    free(expected);
+    free(data);
+    free(buffer);
+    return 0;
+}
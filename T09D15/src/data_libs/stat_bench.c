@@ -0,0 +1,84 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "data_stat.h"
+
+#define BENCH_COUNT 100000000LL
+#define BENCH_REPEATS 3
+
+/*
+    The repeated max and min scans go here, so the compiler can't drop them.
+*/
+volatile double rescan_sink;
+
+/*
+    What make_decision and normalization did before: max, min, mean and a
+    two-pass variance as separate scans, plus max and min again.
+*/
+data_summary separate_scans(const double *data, long long n) {
+    data_summary stats = {n, data[0], data[0], 0, 0};
+    for (long long i = 0; i < n; i++) {
+        stats.max = data[i] > stats.max ? data[i] : stats.max;
+    }
+    for (long long i = 0; i < n; i++) {
+        stats.min = data[i] < stats.min ? data[i] : stats.min;
+    }
+    for (long long i = 0; i < n; i++) {
+        stats.mean += data[i];
+    }
+    stats.mean /= n;
+    for (long long i = 0; i < n; i++) {
+        stats.m2 += (data[i] - stats.mean) * (data[i] - stats.mean);
+    }
+    double again_max = data[0], again_min = data[0];
+    for (long long i = 0; i < n; i++) {
+        again_max = data[i] > again_max ? data[i] : again_max;
+    }
+    for (long long i = 0; i < n; i++) {
+        again_min = data[i] < again_min ? data[i] : again_min;
+    }
+    rescan_sink = again_max + again_min;
+    return stats;
+}
+
+int main(void) {
+    double *data = (double *)malloc(BENCH_COUNT * sizeof(double));
+    if (data == NULL) {
+        printf("n/a");
+        return 0;
+    }
+    fill_uniform(data, BENCH_COUNT, 1e6, 1e6 + 1);
+    long double sum = 0, squares = 0;
+    for (long long i = 0; i < BENCH_COUNT; i++) {
+        sum += data[i];
+    }
+    long double exact_mean = sum / BENCH_COUNT;
+    for (long long i = 0; i < BENCH_COUNT; i++) {
+        squares += (data[i] - exact_mean) * (data[i] - exact_mean);
+    }
+    double exact_variance = (double)(squares / BENCH_COUNT);
+
+    double best_separate = 1e9, best_fused = 1e9;
+    data_summary separate = {0, 0, 0, 0, 0}, fused = separate;
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        double start = now_seconds();
+        separate = separate_scans(data, BENCH_COUNT);
+        best_separate = fmin(best_separate, now_seconds() - start);
+        start = now_seconds();
+        fused = summary(data, BENCH_COUNT);
+        best_fused = fmin(best_fused, now_seconds() - start);
+    }
+
+    double gb = BENCH_COUNT * sizeof(double) * 1e-9;
+    printf("%lld doubles (%.1f GB)\n", BENCH_COUNT, gb);
+    printf("six scans: %7.1f ms, %5.2f GB/s per scan, variance rel. error %.1e\n", best_separate * 1e3,
+           6 * gb / best_separate, fabs(summary_variance(&separate) - exact_variance) / exact_variance);
+    printf("summary:   %7.1f ms, %5.2f GB/s, variance rel. error %.1e, min %.6f, max %.6f\n",
+           best_fused * 1e3, gb / best_fused,
+           fabs(summary_variance(&fused) - exact_variance) / exact_variance, fused.min, fused.max);
+
+    free(data);
+    return 0;
+}
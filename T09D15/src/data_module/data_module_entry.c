@@ -1,14 +1,26 @@
-void main()
-{
-    double *data;
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../data_libs/data_io.h"
+#include "data_process.h"
+
+int main(void) {
     int n;
-    
-    //Don`t forget to allocate memory !
+    double *data = NULL;
 
-    input(data, n);
+    if (scanf("%d", &n) == 1 && n > 0) {
+        data = (double *)malloc(n * sizeof(double));
+    }
+    if (data != NULL && input(data, n)) {
+        if (normalization(data, n)) {
+            output(data, n);
+        } else {
+            printf("ERROR");
+        }
+    } else {
+        printf("n/a");
+    }
 
-    if (normalization(data, n))
-        output(data, n);
-    else
-        printf("ERROR");  
+    free(data);
+    return 0;
 }
@@ -1,24 +1,144 @@
 #include "data_process.h"
+
 #include <math.h>
 
-int normalization(double *data, int n)
-{
-    int result = 1;
-    double max_value = max(data, n);
-    double min_value = min(data, n);
-    double size = max_value - min_value;
-
-    if(fabs(size) < EPS)
-    {
-        for (int i = 0; i < n; i++)
-        {
-            data[i] = data[i] / size - min_value / size;
-        }
-    }
-    else
-    {
-        result = 0;
-    }
-    
+#include "../data_libs/data_stat.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX512F__)
+void scale_kernel(const double *data, long long n, double offset, double scale, double *result) {
+    __m512d o = _mm512_set1_pd(offset), s = _mm512_set1_pd(scale);
+    long long i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d a = _mm512_sub_pd(_mm512_loadu_pd(data + i), o);
+        __m512d b = _mm512_sub_pd(_mm512_loadu_pd(data + i + 8), o);
+        _mm512_storeu_pd(result + i, _mm512_mul_pd(a, s));
+        _mm512_storeu_pd(result + i + 8, _mm512_mul_pd(b, s));
+    }
+    for (; i < n; i++) {
+        result[i] = (data[i] - offset) * scale;
+    }
+}
+
+void scale_kernel_float(const double *data, long long n, double offset, double scale, float *result) {
+    __m512d o = _mm512_set1_pd(offset), s = _mm512_set1_pd(scale);
+    long long i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm512_cvtpd_ps(_mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(data + i), o), s));
+        __m256 b = _mm512_cvtpd_ps(_mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(data + i + 8), o), s));
+        _mm256_storeu_ps(result + i, a);
+        _mm256_storeu_ps(result + i + 8, b);
+    }
+    for (; i < n; i++) {
+        result[i] = (float)((data[i] - offset) * scale);
+    }
+}
+#elif defined(__AVX2__)
+void scale_kernel(const double *data, long long n, double offset, double scale, double *result) {
+    __m256d o = _mm256_set1_pd(offset), s = _mm256_set1_pd(scale);
+    long long i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d a = _mm256_sub_pd(_mm256_loadu_pd(data + i), o);
+        __m256d b = _mm256_sub_pd(_mm256_loadu_pd(data + i + 4), o);
+        _mm256_storeu_pd(result + i, _mm256_mul_pd(a, s));
+        _mm256_storeu_pd(result + i + 4, _mm256_mul_pd(b, s));
+    }
+    for (; i < n; i++) {
+        result[i] = (data[i] - offset) * scale;
+    }
+}
+
+void scale_kernel_float(const double *data, long long n, double offset, double scale, float *result) {
+    __m256d o = _mm256_set1_pd(offset), s = _mm256_set1_pd(scale);
+    long long i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d a = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(data + i), o), s);
+        __m256d b = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(data + i + 4), o), s);
+        __m256 both = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(a)), _mm256_cvtpd_ps(b), 1);
+        _mm256_storeu_ps(result + i, both);
+    }
+    for (; i < n; i++) {
+        result[i] = (float)((data[i] - offset) * scale);
+    }
+}
+#elif defined(__SSE2__)
+void scale_kernel(const double *data, long long n, double offset, double scale, double *result) {
+    __m128d o = _mm_set1_pd(offset), s = _mm_set1_pd(scale);
+    long long i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d a = _mm_sub_pd(_mm_loadu_pd(data + i), o);
+        __m128d b = _mm_sub_pd(_mm_loadu_pd(data + i + 2), o);
+        _mm_storeu_pd(result + i, _mm_mul_pd(a, s));
+        _mm_storeu_pd(result + i + 2, _mm_mul_pd(b, s));
+    }
+    for (; i < n; i++) {
+        result[i] = (data[i] - offset) * scale;
+    }
+}
+
+void scale_kernel_float(const double *data, long long n, double offset, double scale, float *result) {
+    __m128d o = _mm_set1_pd(offset), s = _mm_set1_pd(scale);
+    long long i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 a = _mm_cvtpd_ps(_mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(data + i), o), s));
+        __m128 b = _mm_cvtpd_ps(_mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(data + i + 2), o), s));
+        _mm_storeu_ps(result + i, _mm_movelh_ps(a, b));
+    }
+    for (; i < n; i++) {
+        result[i] = (float)((data[i] - offset) * scale);
+    }
+}
+#else
+void scale_kernel(const double *data, long long n, double offset, double scale, double *result) {
+    for (long long i = 0; i < n; i++) {
+        result[i] = (data[i] - offset) * scale;
+    }
+}
+
+void scale_kernel_float(const double *data, long long n, double offset, double scale, float *result) {
+    for (long long i = 0; i < n; i++) {
+        result[i] = (float)((data[i] - offset) * scale);
+    }
+}
+#endif
+
+/*
+    output: 1 and the kernel parameters if the range is wider than EPS
+*/
+int scale_parameters(const double *data, int n, double *offset, double *scale) {
+    double lo = 0, hi = 0;
+    extremes(data, n, &lo, &hi);
+    int result = n > 0 && fabs(hi - lo) > EPS;
+    if (result) {
+        *offset = lo;
+        *scale = 1.0 / (hi - lo);
+    }
     return result;
 }
+
+int normalization(double *data, int n) { return normalize_to(data, n, data); }
+
+int normalize_to(const double *data, int n, double *result) {
+    double offset, scale;
+    int ok = scale_parameters(data, n, &offset, &scale);
+    if (ok) {
+        scale_kernel(data, n, offset, scale, result);
+    }
+    return ok;
+}
+
+int normalize_to_float(const double *data, int n, float *result) {
+    double offset, scale;
+    int ok = scale_parameters(data, n, &offset, &scale);
+    if (ok) {
+        scale_kernel_float(data, n, offset, scale, result);
+    }
+    return ok;
+}
+
+void rescale(double *data, int n, double min_value, double size) {
+    scale_kernel(data, n, min_value, 1.0 / size, data);
+}
@@ -3,12 +3,24 @@
 
 #define EPS 1E-6
 
-
+/*
+    Rescales data to [0, 1] in place: one SIMD pass for min/max, then
+    (x - min) * scale per element with scale = 1 / (max - min).
+    output: 0 if all values are equal (within EPS); data is left unchanged
+*/
 int normalization(double *data, int n);
 
-#endif
-
+/*
+    Out-of-place forms writing into a caller buffer of n elements; result may
+    alias data in normalize_to.
+*/
+int normalize_to(const double *data, int n, double *result);
+int normalize_to_float(const double *data, int n, float *result);
 
+/*
+    data[i] = (data[i] - min_value) / size, for chunks normalized with
+    statistics gathered beforehand.
+*/
+void rescale(double *data, int n, double min_value, double size);
 
-
-            
+#endif
@@ -0,0 +1,76 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../data_libs/bench.h"
+#include "data_process.h"
+
+#define BENCH_COUNT 50000000
+#define BENCH_REPEATS 3
+
+/*
+    The previous normalization: separate max and min scans, then two
+    divides per element.
+*/
+void old_normalization(double *data, int n) {
+    double max_value = data[0], min_value = data[0];
+    for (int i = 0; i < n; i++) {
+        max_value = data[i] > max_value ? data[i] : max_value;
+    }
+    for (int i = 0; i < n; i++) {
+        min_value = data[i] < min_value ? data[i] : min_value;
+    }
+    double size = max_value - min_value;
+    for (int i = 0; i < n; i++) {
+        data[i] = data[i] / size - min_value / size;
+    }
+}
+
+int main(void) {
+    double *data = (double *)malloc(BENCH_COUNT * sizeof(double));
+    double *reference = (double *)malloc(BENCH_COUNT * sizeof(double));
+    double *result = (double *)malloc(BENCH_COUNT * sizeof(double));
+    float *narrow = (float *)malloc(BENCH_COUNT * sizeof(float));
+    if (data == NULL || reference == NULL || result == NULL || narrow == NULL) {
+        printf("n/a");
+        return 0;
+    }
+
+    double best[4] = {1e9, 1e9, 1e9, 1e9};
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        fill_uniform(reference, BENCH_COUNT, -50, 150);
+        double start = now_seconds();
+        old_normalization(reference, BENCH_COUNT);
+        best[0] = fmin(best[0], now_seconds() - start);
+
+        fill_uniform(data, BENCH_COUNT, -50, 150);
+        start = now_seconds();
+        normalize_to(data, BENCH_COUNT, result);
+        best[1] = fmin(best[1], now_seconds() - start);
+        start = now_seconds();
+        normalize_to_float(data, BENCH_COUNT, narrow);
+        best[2] = fmin(best[2], now_seconds() - start);
+        start = now_seconds();
+        normalization(data, BENCH_COUNT);
+        best[3] = fmin(best[3], now_seconds() - start);
+    }
+
+    double error = 0, narrow_error = 0;
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        error = fmax(error, fabs(data[i] - reference[i]));
+        error = fmax(error, fabs(result[i] - reference[i]));
+        narrow_error = fmax(narrow_error, fabs(narrow[i] - reference[i]));
+    }
+    printf("%d doubles\n", BENCH_COUNT);
+    printf("old normalization:    %7.1f ms\n", best[0] * 1e3);
+    printf("normalize_to:         %7.1f ms\n", best[1] * 1e3);
+    printf("normalize_to_float:   %7.1f ms\n", best[2] * 1e3);
+    printf("normalization:        %7.1f ms\n", best[3] * 1e3);
+    printf("max difference: double %.1e, float %.1e\n", error, narrow_error);
+
+    free(data);
+    free(reference);
+    free(result);
+    free(narrow);
+    return 0;
+}
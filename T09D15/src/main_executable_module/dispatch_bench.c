@@ -0,0 +1,67 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../data_libs/bench.h"
+#include "process_loader.h"
+
+#define BENCH_COUNT 20000000
+#define BENCH_REPEATS 5
+#define CACHED_COUNT (1 << 14)
+#define CACHED_LOOPS 2000
+
+double best_time(const process_kernels *kernels, const double *data, int n, int loops, double *result) {
+    double best = 1e9;
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        double start = now_seconds();
+        for (int i = 0; i < loops; i++) {
+            kernels->normalize_to(data, n, result);
+        }
+        best = fmin(best, now_seconds() - start);
+    }
+    return best;
+}
+
+/*
+    Best-of times of normalize_to for one variant, on BENCH_COUNT values
+    (memory bound) and CACHED_LOOPS times on CACHED_COUNT values that stay
+    in L1/L2. The output of every variant is compared with the first one.
+*/
+void bench_variant(const char *variant, const double *data, double *result, double *reference) {
+    process_kernels kernels;
+    if (!process_open(&kernels, variant)) {
+        printf("%-8s not available\n", variant);
+    } else {
+        double cached = best_time(&kernels, data, CACHED_COUNT, CACHED_LOOPS, result);
+        double full = best_time(&kernels, data, BENCH_COUNT, 1, result);
+        if (isnan(reference[0])) {
+            memcpy(reference, result, BENCH_COUNT * sizeof(double));
+        }
+        printf("%-8s %7.1f ms %7.1f ms [%s]\n", variant, cached * 1e3, full * 1e3,
+               memcmp(reference, result, BENCH_COUNT * sizeof(double)) ? "MISMATCH" : "ok");
+        process_close(&kernels);
+    }
+}
+
+int main(void) {
+    const char *variants[] = {"scalar", "generic", "sse42", "avx2", "avx512"};
+    double *data = (double *)malloc(BENCH_COUNT * sizeof(double));
+    double *result = (double *)malloc(BENCH_COUNT * sizeof(double));
+    double *reference = (double *)malloc(BENCH_COUNT * sizeof(double));
+    if (data == NULL || result == NULL || reference == NULL) {
+        printf("n/a");
+    } else {
+        fill_uniform(data, BENCH_COUNT, -50, 150);
+        reference[0] = NAN;
+        printf("normalize_to, picked for this CPU: %s\n", process_best_variant());
+        printf("variant  %d x %d  %d x 1\n", CACHED_LOOPS, CACHED_COUNT, BENCH_COUNT);
+        for (int i = 0; i < 5; i++) {
+            bench_variant(variants[i], data, result, reference);
+        }
+    }
+    free(data);
+    free(result);
+    free(reference);
+    return 0;
+}
@@ -1,24 +1,75 @@
-void main()
-{
-    double *data;
-    int n;
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef DATA_IO_MACRO
+#include "../data_libs/data_io_macro.h"
+#else
+#include "../data_libs/data_io.h"
+#endif
+#include "../data_libs/data_sort.h"
+#include "../data_module/data_process.h"
+#include "../yet_another_decision_module/decision.h"
+#include "stream_pipeline.h"
+
+int run_in_memory(void);
+
+/*
+    main_executable_module [--stream file [--chunk N]]
+    Without arguments the data is read from stdin and processed in memory.
+    --stream processes a file of any size in chunks of N values.
+*/
+int main(int argc, char **argv) {
+    int result = 1;
+    const char *path = NULL;
+    long long chunk = STREAM_CHUNK_DEFAULT;
+
+    for (int i = 1; i + 1 < argc && result; i += 2) {
+        if (strcmp(argv[i], "--stream") == 0) {
+            path = argv[i + 1];
+        } else if (strcmp(argv[i], "--chunk") == 0) {
+            chunk = atoll(argv[i + 1]);
+        } else {
+            result = 0;
+        }
+    }
 
     printf("LOAD DATA...\n");
-    input(data, n);
-
-    printf("RAW DATA:\n\t");
-    output(data, n);
-
-    printf("\nNORMALIZED DATA:\n\t");
-    normalization(data, n);
-    output(data, n);
-    
-    printf("\nSORTED NORMALIZED DATA:\n\t");
-    sort(data, n);
-    output(data, n);
-    
-    printf("\nFINAL DECISION:\n\t");
-    //make_decision(data, n);
-    //...
-    
+    if (result && path != NULL) {
+        result = stream_pipeline(path, chunk);
+    } else if (result) {
+        result = run_in_memory();
+    }
+    if (!result) {
+        printf("n/a");
+    }
+    return 0;
+}
+
+int run_in_memory(void) {
+    int n, result = 0;
+    double *data = NULL;
+
+    if (scanf("%d", &n) == 1 && n > 0) {
+        data = (double *)malloc(n * sizeof(double));
+    }
+    if (data != NULL && input(data, n)) {
+        printf("RAW DATA:\n\t");
+        output(data, n);
+
+        printf("\nNORMALIZED DATA:\n\t");
+        normalization(data, n);
+        output(data, n);
+
+        printf("\nSORTED NORMALIZED DATA:\n\t");
+        sort(data, n);
+        output(data, n);
+
+        printf("\nFINAL DECISION:\n\t");
+        printf(make_decision(data, n) ? "YES" : "NO");
+        result = 1;
+    }
+
+    free(data);
+    return result;
 }
@@ -0,0 +1,127 @@
+#include "process_loader.h"
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../data_module/data_process.h"
+
+static const char *const variant_names[PROCESS_VARIANTS] = {"avx512", "avx2", "sse42", "generic", "scalar"};
+
+static process_kernels active;
+static pthread_once_t active_once = PTHREAD_ONCE_INIT;
+
+int variant_index(const char *variant) {
+    int index = PROCESS_VARIANTS;
+    for (int i = 0; i < PROCESS_VARIANTS && index == PROCESS_VARIANTS; i++) {
+        if (strcmp(variant, variant_names[i]) == 0) {
+            index = i;
+        }
+    }
+    return index;
+}
+
+int variant_supported(int index) {
+    int result = 1;
+    __builtin_cpu_init();
+    if (index == 0) {
+        result = __builtin_cpu_supports("avx512f");
+    } else if (index == 1) {
+        result = __builtin_cpu_supports("avx2");
+    } else if (index == 2) {
+        result = __builtin_cpu_supports("sse4.2");
+    }
+    return result;
+}
+
+int process_open(process_kernels *kernels, const char *variant) {
+    int index = variant_index(variant);
+    char path[64] = "data_process.so";
+    memset(kernels, 0, sizeof(process_kernels));
+    if (index < PROCESS_VARIANTS && strcmp(variant, "generic") != 0) {
+        snprintf(path, sizeof(path), "data_process_%s.so", variant);
+    }
+    if (index < PROCESS_VARIANTS) {
+        kernels->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    }
+    if (kernels->handle != NULL) {
+        kernels->variant = variant_names[index];
+        kernels->normalization = (int (*)(double *, int))dlsym(kernels->handle, "normalization");
+        kernels->normalize_to =
+            (int (*)(const double *, int, double *))dlsym(kernels->handle, "normalize_to");
+        kernels->normalize_to_float =
+            (int (*)(const double *, int, float *))dlsym(kernels->handle, "normalize_to_float");
+        kernels->rescale = (void (*)(double *, int, double, double))dlsym(kernels->handle, "rescale");
+    }
+    int result = kernels->normalization != NULL && kernels->normalize_to != NULL &&
+                 kernels->normalize_to_float != NULL && kernels->rescale != NULL;
+    if (!result) {
+        process_close(kernels);
+    }
+    return result;
+}
+
+void process_close(process_kernels *kernels) {
+    if (kernels->handle != NULL) {
+        dlclose(kernels->handle);
+    }
+    memset(kernels, 0, sizeof(process_kernels));
+}
+
+const char *process_best_variant(void) {
+    const char *variant = getenv(PROCESS_VARIANT_ENV);
+    int index = 0;
+    if (variant != NULL && *variant == '\0') {
+        variant = NULL;
+    }
+    int forced = (variant != NULL) ? variant_index(variant) : PROCESS_VARIANTS;
+    if (forced < PROCESS_VARIANTS && !variant_supported(forced)) {
+        fprintf(stderr, "data_process: this CPU does not support variant %s, using the best supported one\n",
+                variant);
+        variant = NULL;
+    }
+    while (variant == NULL && index < PROCESS_VARIANTS) {
+        if (variant_supported(index)) {
+            variant = variant_names[index];
+        }
+        index++;
+    }
+    return variant;
+}
+
+void load_active(void) {
+    const char *wanted = process_best_variant();
+    int loaded = process_open(&active, wanted);
+    if (!loaded) {
+        const char *error = dlerror();
+        fprintf(stderr, "data_process: cannot load variant %s: %s\n", wanted, error ? error : "unknown name");
+    }
+    for (int i = 0; i < PROCESS_VARIANTS && !loaded; i++) {
+        loaded = variant_supported(i) && process_open(&active, variant_names[i]);
+    }
+}
+
+const char *process_variant(void) {
+    pthread_once(&active_once, load_active);
+    return active.variant;
+}
+
+int normalization(double *data, int n) {
+    return process_variant() != NULL && active.normalization(data, n);
+}
+
+int normalize_to(const double *data, int n, double *result) {
+    return process_variant() != NULL && active.normalize_to(data, n, result);
+}
+
+int normalize_to_float(const double *data, int n, float *result) {
+    return process_variant() != NULL && active.normalize_to_float(data, n, result);
+}
+
+void rescale(double *data, int n, double min_value, double size) {
+    if (process_variant() != NULL) {
+        active.rescale(data, n, min_value, size);
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef PROCESS_LOADER_H
+#define PROCESS_LOADER_H
+
+#define PROCESS_VARIANT_ENV "DATA_PROCESS_VARIANT"
+#define PROCESS_VARIANTS 5
+
+/*
+    The kernels of one CPU-specific build of data_process, loaded with
+    dlopen. Variants, best first: avx512, avx2, sse42, generic (the plain
+    data_process.so, SSE2 as every x86-64 has) and scalar (no SIMD at all).
+    Variant v lives in data_process_v.so; libraries are searched through
+    the run path of the executable, i.e. next to it for Quest_6.
+*/
+typedef struct process_kernels {
+    void *handle;
+    const char *variant;
+    int (*normalization)(double *data, int n);
+    int (*normalize_to)(const double *data, int n, double *result);
+    int (*normalize_to_float)(const double *data, int n, float *result);
+    void (*rescale)(double *data, int n, double min_value, double size);
+} process_kernels;
+
+/*
+    output: 1 if variant is known, its library loaded and it exports every
+            kernel; the CPU is not checked, so forcing a variant it lacks
+            ends in SIGILL
+*/
+int process_open(process_kernels *kernels, const char *variant);
+void process_close(process_kernels *kernels);
+
+/*
+    The variant named by $DATA_PROCESS_VARIANT if set and supported by this
+    CPU, else the best one it supports according to __builtin_cpu_supports.
+    A forced variant the CPU lacks is reported on stderr and skipped.
+*/
+const char *process_best_variant(void);
+
+/*
+    The variant behind the data_process.h functions, which this module
+    implements by forwarding: on first use it loads process_best_variant(),
+    falling back to the next supported one on failure. NULL if none loaded.
+*/
+const char *process_variant(void);
+
+#endif
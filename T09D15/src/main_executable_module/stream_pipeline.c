@@ -0,0 +1,129 @@
+#include "stream_pipeline.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../data_libs/data_stat.h"
+#include "../data_libs/external_sort.h"
+#include "../data_module/data_process.h"
+#include "../yet_another_decision_module/decision.h"
+
+/*
+    Prints like output(), continuing the same line across calls; context
+    points to a flag that is 1 before the first value.
+*/
+void print_values(void *context, const double *values, long long n) {
+    int *first = (int *)context;
+    for (long long i = 0; i < n; i++) {
+        if (!*first) {
+            printf(" ");
+        }
+        printf("%.2lf", values[i]);
+        *first = 0;
+    }
+}
+
+int read_chunk(FILE *file, double *buffer, long long count) {
+    int result = 1;
+    for (long long i = 0; i < count && result; i++) {
+        result = fscanf(file, "%lf", &buffer[i]) == 1;
+    }
+    return result;
+}
+
+int raw_pass(FILE *file, long long n, double *buffer, long long chunk, data_summary *stats) {
+    int result = 1, first = 1;
+    summary_init(stats);
+    for (long long done = 0; done < n && result; done += chunk) {
+        long long count = (n - done < chunk) ? n - done : chunk;
+        result = read_chunk(file, buffer, count);
+        if (result) {
+            print_values(&first, buffer, count);
+            summary_add(stats, buffer, count);
+        }
+    }
+    return result;
+}
+
+int normalize_pass(FILE *file, long long n, double *buffer, long long chunk, const data_summary *stats,
+                   external_sorter *sorter) {
+    double size = stats->max - stats->min;
+    int result = 1, first = 1;
+    for (long long done = 0; done < n && result; done += chunk) {
+        long long count = (n - done < chunk) ? n - done : chunk;
+        result = read_chunk(file, buffer, count);
+        if (result && fabs(size) > EPS) {
+            rescale(buffer, (int)count, stats->min, size);
+        }
+        if (result) {
+            print_values(&first, buffer, count);
+            result = sorter_push(sorter, buffer, count);
+        }
+    }
+    return result;
+}
+
+/*
+    Statistics of (x - min) / size derived from those of x.
+*/
+data_summary rescale_summary(const data_summary *stats) {
+    data_summary result = *stats;
+    double size = stats->max - stats->min;
+    if (fabs(size) > EPS) {
+        result.min = 0;
+        result.max = 1;
+        result.mean = (stats->mean - stats->min) / size;
+        result.m2 = stats->m2 / (size * size);
+    }
+    return result;
+}
+
+int run_passes(FILE *file, long long n, double *buffer, long long chunk, external_sorter *sorter) {
+    data_summary stats;
+    long long check = 0;
+    int first = 1;
+
+    printf("RAW DATA:\n\t");
+    int result = raw_pass(file, n, buffer, chunk, &stats);
+    if (result) {
+        rewind(file);
+        result = fscanf(file, "%lld", &check) == 1 && check == n;
+    }
+    if (result) {
+        printf("\nNORMALIZED DATA:\n\t");
+        result = normalize_pass(file, n, buffer, chunk, &stats, sorter);
+    }
+    if (result) {
+        printf("\nSORTED NORMALIZED DATA:\n\t");
+        result = sorter_finish(sorter, print_values, &first);
+    }
+    if (result) {
+        data_summary normalized = rescale_summary(&stats);
+        printf("\nFINAL DECISION:\n\t%s", decide(&normalized) ? "YES" : "NO");
+    }
+    return result;
+}
+
+int stream_pipeline(const char *path, long long chunk) {
+    FILE *file = fopen(path, "r");
+    long long n = 0;
+    int result = file != NULL && fscanf(file, "%lld", &n) == 1 && n > 0 && chunk > 0;
+    double *buffer = NULL;
+    external_sorter sorter = {NULL, 0, 0, NULL, 0, NULL, 0, 0};
+
+    if (result) {
+        buffer = (double *)malloc(chunk * sizeof(double));
+        result = buffer != NULL && sorter_init(&sorter, chunk);
+    }
+    if (result) {
+        result = run_passes(file, n, buffer, chunk, &sorter);
+    }
+
+    sorter_free(&sorter);
+    free(buffer);
+    if (file != NULL) {
+        fclose(file);
+    }
+    return result;
+}
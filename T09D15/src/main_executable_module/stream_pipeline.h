@@ -0,0 +1,17 @@
+#ifndef STREAM_PIPELINE_H
+#define STREAM_PIPELINE_H
+
+#define STREAM_CHUNK_DEFAULT (1 << 20)
+
+/*
+    The main_executable_module pipeline over a file in the stdin format
+    ("n" followed by n values) that does not have to fit in memory:
+    pass 1 prints the raw data and gathers the statistics, pass 2 prints the
+    normalized data and feeds it to an external sort, and the decision is
+    taken on the statistics rescaled like the data. Memory is bounded by
+    three buffers of chunk values (input, sort chunk and sort scratch).
+    output: 1 on success, 0 if the file is missing, malformed or short
+*/
+int stream_pipeline(const char *path, long long chunk);
+
+#endif
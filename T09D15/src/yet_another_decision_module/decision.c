@@ -1,15 +1,110 @@
-int make_decision(double *data, int n)
-{
-    int decision = 1;
+#include "decision.h"
 
-    double m = mean(data, n);
-    double sigma = sqrt(variance(data, n));
-    double max_value = max(data, n);
-    double min_value = min(data, n);
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
 
-    decision &= (max_value <= m + 3*sigma) &&
-                (max_value >= m - 3*sigma) &&
-                (m >= GOLDEN_RATIO);
+int make_decision(double *data, int n) {
+    data_summary stats = summary(data, n);
+    return decide(&stats);
+}
+
+int decide(const data_summary *stats) {
+    double m = stats->mean;
+    double sigma = sqrt(summary_variance(stats));
+
+    return (stats->max <= m + 3 * sigma) && (stats->max >= m - 3 * sigma) && (m >= GOLDEN_RATIO);
+}
+
+typedef struct batch_task {
+    const double *data;
+    const long long *offsets;
+    int first;
+    int last;
+    unsigned long long *mask;
+    long long yes;
+} batch_task;
+
+/*
+    Decisions are collected in a local word and stored once per 64 series;
+    task ranges start at multiples of 64, so only the last word is partial.
+*/
+void *batch_main(void *arg) {
+    batch_task *task = (batch_task *)arg;
+    unsigned long long word = 0;
+    long long yes = 0;
+    for (int i = task->first; i < task->last; i++) {
+        long long start = task->offsets[i];
+        data_summary stats = summary(task->data + start, task->offsets[i + 1] - start);
+        int decision = decide(&stats);
+        word |= (unsigned long long)decision << (i % 64);
+        yes += decision;
+        if (i % 64 == 63 || i + 1 == task->last) {
+            task->mask[i / 64] = word;
+            word = 0;
+        }
+    }
+    task->yes = yes;
+    return NULL;
+}
+
+/*
+    First series starting at or after value index target, rounded down to a
+    multiple of 64.
+*/
+int batch_bound(const long long *offsets, int count, long long target) {
+    int low = 0, high = count;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (offsets[middle] < target) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low - low % 64;
+}
+
+int batch_threads(long long total, int count, int threads) {
+    if (threads <= 0) {
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    threads = (threads > DECISION_MAX_THREADS) ? DECISION_MAX_THREADS : (threads < 1 ? 1 : threads);
+    if (threads > (count + 63) / 64) {
+        threads = (count + 63) / 64;
+    }
+    return (total < DECISION_PARALLEL_MIN || threads < 1) ? 1 : threads;
+}
+
+long long decide_batch(const double *data, const long long *offsets, int count, unsigned long long *mask,
+                       int threads) {
+    long long total = (count > 0) ? offsets[count] - offsets[0] : 0, yes = 0;
+    batch_task tasks[DECISION_MAX_THREADS];
+    pthread_t ids[DECISION_MAX_THREADS];
+    int started[DECISION_MAX_THREADS];
+    threads = batch_threads(total, count, threads);
 
-    return decision;
+    for (int t = 0; t < threads; t++) {
+        int first = batch_bound(offsets, count, offsets[0] + total * t / threads);
+        int last = count;
+        if (t + 1 < threads) {
+            last = batch_bound(offsets, count, offsets[0] + total * (t + 1) / threads);
+        }
+        batch_task task = {data, offsets, first, last, mask, 0};
+        tasks[t] = task;
+    }
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&ids[t], NULL, batch_main, &tasks[t]) == 0;
+        if (!started[t]) {
+            batch_main(&tasks[t]);
+        }
+    }
+    batch_main(&tasks[0]);
+    for (int t = 0; t < threads; t++) {
+        if (t > 0 && started[t]) {
+            pthread_join(ids[t], NULL);
+        }
+        yes += tasks[t].yes;
+    }
+    return yes;
 }
@@ -1,8 +1,35 @@
-#define GOLDEN_RATIO 0.666
+#ifndef DECISION_H
+#define DECISION_H
 
+#define GOLDEN_RATIO 0.666
+#define DECISION_PARALLEL_MIN (1 << 16)
+#define DECISION_MAX_THREADS 64
 
+#include "../data_libs/data_stat.h"
 
+/*
+    1 if max lies within mean +- 3 sigma and mean >= GOLDEN_RATIO.
+*/
+int make_decision(double *data, int n);
 
+/*
+    The same criterion on statistics already gathered, e.g. by summary_add
+    over a stream.
+*/
+int decide(const data_summary *stats);
 
+/*
+    make_decision for count series packed back to back in data: series i is
+    data[offsets[i] .. offsets[i + 1] - 1], so offsets holds count + 1
+    entries. Bit i % 64 of mask[i / 64] receives the decision of series i;
+    mask needs (count + 63) / 64 words. Each series is reduced with summary()
+    in one pass while it is in cache. From DECISION_PARALLEL_MIN values on,
+    the series are split into ranges of about equal total length, one per
+    thread (threads <= 0: one per online CPU), each a whole number of mask
+    words so no two threads write the same word.
+    output: the number of YES decisions
+*/
+long long decide_batch(const double *data, const long long *offsets, int count, unsigned long long *mask,
+                       int threads);
 
-            
+#endif
@@ -0,0 +1,125 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../data_libs/bench.h"
+#include "decision.h"
+#include "decision_window.h"
+
+#define BENCH_VALUES 20000000
+#define BENCH_REPEATS 3
+#define THREAD_STEPS 4
+#define WINDOW_SAMPLES 200000
+#define WINDOW_SIZE 1000
+
+/*
+    Series of 1 .. max_length values around GOLDEN_RATIO, one in ten with
+    an outlier, so both answers are common.
+*/
+double *fill(long long *offsets, int series, int max_length) {
+    srand(BENCH_SEED);
+    offsets[0] = 0;
+    for (int i = 0; i < series; i++) {
+        offsets[i + 1] = offsets[i] + 1 + rand() % max_length;
+    }
+    double *data = (double *)malloc(offsets[series] * sizeof(double));
+    for (long long i = 0; data != NULL && i < offsets[series]; i++) {
+        data[i] = (double)rand() / RAND_MAX * 1.4 - 0.02;
+    }
+    for (int i = 0; data != NULL && i < series; i += 10) {
+        data[offsets[i]] = 40;
+    }
+    return data;
+}
+
+long long loop_decisions(const double *data, const long long *offsets, int series, unsigned long long *mask) {
+    double best = 1e9;
+    long long yes = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        double start = now_seconds();
+        yes = 0;
+        for (int i = 0; i < series; i++) {
+            int decision = make_decision((double *)data + offsets[i], (int)(offsets[i + 1] - offsets[i]));
+            mask[i / 64] |= (unsigned long long)decision << (i % 64);
+            yes += decision;
+        }
+        best = fmin(best, now_seconds() - start);
+    }
+    printf("%d series of 1 .. %d values, %lld YES\n", series, 2 * BENCH_VALUES / series - 1, yes);
+    printf("make_decision loop: %7.1f ms\n", best * 1e3);
+    return yes;
+}
+
+void bench(int series) {
+    long long *offsets = (long long *)malloc((series + 1) * sizeof(long long));
+    unsigned long long *expected = (unsigned long long *)calloc((series + 63) / 64, 8);
+    unsigned long long *mask = (unsigned long long *)calloc((series + 63) / 64, 8);
+    double *data = (offsets != NULL) ? fill(offsets, series, 2 * BENCH_VALUES / series - 1) : NULL;
+    int threads[THREAD_STEPS] = {1, 2, 4, 8};
+    if (data == NULL || expected == NULL || mask == NULL) {
+        printf("n/a");
+    } else {
+        long long yes = loop_decisions(data, offsets, series, expected);
+        for (int t = 0; t < THREAD_STEPS; t++) {
+            double best = 1e9;
+            int same = 1;
+            for (int r = 0; r < BENCH_REPEATS; r++) {
+                double start = now_seconds();
+                same = decide_batch(data, offsets, series, mask, threads[t]) == yes;
+                best = fmin(best, now_seconds() - start);
+            }
+            for (int i = 0; i < (series + 63) / 64; i++) {
+                same = same && mask[i] == expected[i];
+            }
+            printf("decide_batch(%d):    %7.1f ms [%s]\n", threads[t], best * 1e3, same ? "ok" : "MISMATCH");
+        }
+    }
+    free(offsets);
+    free(expected);
+    free(mask);
+    free(data);
+}
+
+/*
+    A sliding window over a stream: make_decision on the last WINDOW_SIZE
+    values after every sample against window_push + window_evaluate.
+*/
+void bench_window(const double *data, char *expected) {
+    decision_window window;
+    if (window_init(&window, WINDOW_SIZE)) {
+        double start = now_seconds();
+        for (int i = 0; i < WINDOW_SAMPLES; i++) {
+            int first = (i + 1 > WINDOW_SIZE) ? i + 1 - WINDOW_SIZE : 0;
+            expected[i] = (char)make_decision((double *)data + first, i + 1 - first);
+        }
+        double rerun = now_seconds() - start;
+        long long differ = 0;
+        start = now_seconds();
+        for (int i = 0; i < WINDOW_SAMPLES; i++) {
+            window_push(&window, data[i]);
+            differ += window_evaluate(&window) != expected[i];
+        }
+        double online = now_seconds() - start;
+        printf("%d samples, window %d\n", WINDOW_SAMPLES, WINDOW_SIZE);
+        printf("make_decision per sample: %7.1f ms\n", rerun * 1e3);
+        printf("window_push + evaluate:   %7.1f ms, %lld decisions differ\n", online * 1e3, differ);
+        window_free(&window);
+    }
+}
+
+int main(void) {
+    bench(200000);
+    bench(2000000);
+    double *data = (double *)malloc(WINDOW_SAMPLES * sizeof(double));
+    char *expected = (char *)malloc(WINDOW_SAMPLES);
+    if (data != NULL && expected != NULL) {
+        srand(BENCH_SEED);
+        for (int i = 0; i < WINDOW_SAMPLES; i++) {
+            data[i] = (double)rand() / RAND_MAX * 1.4 - 0.04 + ((rand() % 5000) ? 0 : 40);
+        }
+        bench_window(data, expected);
+    }
+    free(data);
+    free(expected);
+    return 0;
+}
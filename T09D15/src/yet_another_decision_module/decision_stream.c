@@ -0,0 +1,28 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "decision_window.h"
+
+#define STREAM_WINDOW_DEFAULT 1024
+
+/*
+    decision_stream [window]
+    Reads values from stdin until EOF or a malformed token and prints the
+    decision over the last window values after every one of them.
+*/
+int main(int argc, char **argv) {
+    long long capacity = (argc > 1) ? atoll(argv[1]) : STREAM_WINDOW_DEFAULT;
+    decision_window window;
+    double value;
+
+    if (argc > 2 || !window_init(&window, capacity)) {
+        printf("n/a");
+    } else {
+        while (scanf("%lf", &value) == 1) {
+            window_push(&window, value);
+            fputs(window_evaluate(&window) ? "YES\n" : "NO\n", stdout);
+        }
+        window_free(&window);
+    }
+    return 0;
+}
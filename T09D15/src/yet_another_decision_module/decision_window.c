@@ -0,0 +1,114 @@
+#include "decision_window.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+int window_init(decision_window *window, long long capacity) {
+    window->capacity = capacity;
+    window->count = 0;
+    window->pushed = 0;
+    window->mean = 0;
+    window->m2 = 0;
+    window->low.head = window->low.size = 0;
+    window->high.head = window->high.size = 0;
+    window->values = NULL;
+    window->low.items = NULL;
+    window->high.items = NULL;
+    if (capacity > 0) {
+        window->values = (double *)malloc(capacity * sizeof(double));
+        window->low.items = (window_entry *)malloc(capacity * sizeof(window_entry));
+        window->high.items = (window_entry *)malloc(capacity * sizeof(window_entry));
+    }
+    int result = window->values != NULL && window->low.items != NULL && window->high.items != NULL;
+    if (!result) {
+        window_free(window);
+    }
+    return result;
+}
+
+void window_free(decision_window *window) {
+    free(window->values);
+    free(window->low.items);
+    free(window->high.items);
+    window->values = NULL;
+    window->low.items = NULL;
+    window->high.items = NULL;
+}
+
+long long wrap(long long i, long long capacity) { return (i >= capacity) ? i - capacity : i; }
+
+const window_entry *deque_at(const window_deque *deque, long long i, long long capacity) {
+    return &deque->items[wrap(deque->head + i, capacity)];
+}
+
+/*
+    Keeps entries whose values are strictly monotonic from the front:
+    ascending for the minimum (sign 1), descending for the maximum
+    (sign -1). The front is the extreme of the window once the entry that
+    just left it is dropped.
+*/
+void deque_push(window_deque *deque, long long capacity, long long seq, double value, int sign) {
+    while (deque->size > 0 && sign * deque_at(deque, deque->size - 1, capacity)->value >= sign * value) {
+        deque->size--;
+    }
+    if (deque->size > 0 && deque_at(deque, 0, capacity)->seq <= seq - capacity) {
+        deque->head = wrap(deque->head + 1, capacity);
+        deque->size--;
+    }
+    window_entry entry = {seq, value};
+    deque->items[wrap(deque->head + deque->size, capacity)] = entry;
+    deque->size++;
+}
+
+/*
+    Exact moments of the ring, oldest part first.
+*/
+void window_refresh(decision_window *window) {
+    data_summary stats;
+    long long start = window->pushed % window->capacity;
+    summary_init(&stats);
+    summary_add(&stats, window->values + start, window->capacity - start);
+    summary_add(&stats, window->values, start);
+    window->mean = stats.mean;
+    window->m2 = stats.m2;
+}
+
+void window_push(decision_window *window, double value) {
+    long long slot = window->pushed % window->capacity;
+    if (window->count < window->capacity) {
+        window->count++;
+        double delta = value - window->mean;
+        window->mean += delta / window->count;
+        window->m2 += delta * (value - window->mean);
+    } else {
+        double old = window->values[slot], mean = window->mean;
+        window->mean += (value - old) / window->count;
+        window->m2 += (value - old) * (value - window->mean + old - mean);
+        window->m2 = (window->m2 > 0) ? window->m2 : 0;
+    }
+    window->values[slot] = value;
+    deque_push(&window->low, window->capacity, window->pushed, value, 1);
+    deque_push(&window->high, window->capacity, window->pushed, value, -1);
+    window->pushed++;
+    if (window->count == window->capacity && window->pushed % window->capacity == 0) {
+        window_refresh(window);
+    }
+}
+
+data_summary window_summary(const decision_window *window) {
+    data_summary stats;
+    summary_init(&stats);
+    if (window->count > 0) {
+        stats.n = window->count;
+        stats.min = deque_at(&window->low, 0, window->capacity)->value;
+        stats.max = deque_at(&window->high, 0, window->capacity)->value;
+        stats.mean = window->mean;
+        stats.m2 = window->m2;
+    }
+    return stats;
+}
+
+int window_evaluate(const decision_window *window) {
+    data_summary stats = window_summary(window);
+    return window->count > 0 && decide(&stats);
+}
@@ -0,0 +1,55 @@
+#ifndef DECISION_WINDOW_H
+#define DECISION_WINDOW_H
+
+#include "decision.h"
+
+/*
+    The make_decision criterion over the last capacity values of a stream.
+    Each push is O(1) amortized: min and max come from monotonic deques of
+    (sequence number, value) pairs, mean and m2 from a Welford update that adds the new
+    value and removes the one leaving the window. The moments are
+    recomputed exactly with summary() once every capacity pushes to stop
+    rounding drift, which is still O(1) per push on average.
+*/
+typedef struct window_entry {
+    long long seq;
+    double value;
+} window_entry;
+
+typedef struct window_deque {
+    window_entry *items;
+    long long head;
+    long long size;
+} window_deque;
+
+typedef struct decision_window {
+    double *values;
+    long long capacity;
+    long long count;
+    long long pushed;
+    double mean;
+    double m2;
+    window_deque low;
+    window_deque high;
+} decision_window;
+
+/*
+    output: 1 on success, 0 if capacity < 1 or allocation failed
+*/
+int window_init(decision_window *window, long long capacity);
+void window_free(decision_window *window);
+
+void window_push(decision_window *window, double value);
+
+/*
+    Statistics of the values currently in the window (fewer than capacity
+    until it fills up).
+*/
+data_summary window_summary(const decision_window *window);
+
+/*
+    decide() on window_summary(); 0 while the window is empty.
+*/
+int window_evaluate(const decision_window *window);
+
+#endif
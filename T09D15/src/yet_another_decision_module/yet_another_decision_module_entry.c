@@ -1,10 +1,26 @@
-void main()
-{
-    double *data;
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../data_libs/data_io.h"
+#include "decision.h"
+
+int main(void) {
     int n;
-    
-    if (make_decision(data, n))
-        printf("YES"); 
-    else
-        printf("NO");  
+    double *data = NULL;
+
+    if (scanf("%d", &n) == 1 && n > 0) {
+        data = (double *)malloc(n * sizeof(double));
+    }
+    if (data != NULL && input(data, n)) {
+        if (make_decision(data, n)) {
+            printf("YES");
+        } else {
+            printf("NO");
+        }
+    } else {
+        printf("n/a");
+    }
+
+    free(data);
+    return 0;
 }
@@ -5,7 +5,7 @@
 
 int main()
 {
-    print_log(print_char, Module_load_successb);
+    print_log(print_char, Module_load_success_message);
     
     //availability_mask = check_available_documentation_module(validate, Documents_count, Documents);
 
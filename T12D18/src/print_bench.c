@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "print_module.h"
+
+#define Bench_lines 1000000
+#define Bench_ring (1 << 20)
+
+FILE* null_file = NULL;
+long sink_writes = 0;
+
+double now_seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+char null_char(char ch)
+{
+    return (char)fputc(ch, null_file);
+}
+
+/* The way print_log worked before: localtime on every message */
+void naive_print_log(char (*print) (char), char* message)
+{
+    time_t now = time(NULL);
+    struct tm parts;
+    char prefix[32];
+    strftime(prefix, sizeof(prefix), Log_prefix " %H:%M:%S ", localtime_r(&now, &parts));
+    for (char* ch = prefix; *ch != '\0'; ch++)
+    {
+        print(*ch);
+    }
+    for (char* ch = message; *ch != '\0'; ch++)
+    {
+        print(*ch);
+    }
+}
+
+void report(const char* name, double seconds)
+{
+    printf("%-14s %6.2f M lines/s, %5.0f ns/line\n", name, Bench_lines / seconds / 1e6,
+           seconds / Bench_lines * 1e9);
+}
+
+void bench_callback(const char* name, void (*log) (char (*print) (char), char* message))
+{
+    char message[64];
+    double start = now_seconds();
+    for (int i = 0; i < Bench_lines; i++)
+    {
+        snprintf(message, sizeof(message), "worker message %d\n", i);
+        log(null_char, message);
+    }
+    fflush(null_file);
+    report(name, now_seconds() - start);
+}
+
+int counted_write(log_sink* sink, const char* data, size_t len)
+{
+    log_sink* target = sink->context;
+    sink_writes++;
+    return target->write(target, data, len);
+}
+
+void bench_writer(const char* name, log_sink* target)
+{
+    log_sink counter = {counted_write, -1, 0, target, NULL};
+    log_writer writer;
+    log_writer_init(&writer, &counter);
+    char message[64];
+    sink_writes = 0;
+    double start = now_seconds();
+    for (int i = 0; i < Bench_lines; i++)
+    {
+        snprintf(message, sizeof(message), "worker message %d", i);
+        log_line(&writer, message);
+    }
+    log_flush(&writer);
+    report(name, now_seconds() - start);
+    printf("%-14s %ld writes for %d lines\n", "", sink_writes, Bench_lines);
+}
+
+/* The ring holds the tail of the log: the last line is the last message */
+int check_ring(const log_ring* ring)
+{
+    static char out[Bench_ring];
+    size_t len = log_ring_read(ring, out);
+    char* last = NULL;
+    int index = -1;
+    for (size_t i = 0; len > 1 && i < len - 1; i++)
+    {
+        last = (out[i] == '\n') ? out + i + 1 : last;
+    }
+    return last != NULL && sscanf(last, Log_prefix " %*d:%*d:%*d worker message %d", &index) == 1 &&
+           index == Bench_lines - 1 && out[len - 1] == '\n';
+}
+
+int main()
+{
+    null_file = fopen("/dev/null", "w");
+    log_sink file = sink_file("/dev/null");
+    log_ring ring;
+    if (null_file == NULL || file.fd < 0 || !log_ring_init(&ring, Bench_ring))
+    {
+        printf("n/a\n");
+        return 1;
+    }
+    bench_callback("naive", naive_print_log);
+    bench_callback("print_log", print_log);
+    bench_writer("writer file", &file);
+    log_sink memory = sink_ring(&ring);
+    bench_writer("writer ring", &memory);
+    printf("ring tail [%s]\n", check_ring(&ring) ? "ok" : "MISMATCH");
+    log_ring_free(&ring);
+    sink_close(&file);
+    fclose(null_file);
+    return 0;
+}
@@ -1,8 +1,217 @@
+#include <fcntl.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include "print_module.h"
 
-int print_char(char ch) 
+char print_char(char ch)
 {
-    return putchar(ch);
+    return (char)putchar(ch);
+}
+
+/*
+    Prefix is sent first and the message after it, so long messages
+    don't need a buffer of their own
+*/
+void print_log(char (*print) (char), char* message)
+{
+    static log_clock clock;
+    char prefix[sizeof(Log_prefix) + sizeof(clock.text) + 1];
+    int len = snprintf(prefix, sizeof(prefix), "%s %s ", Log_prefix, log_clock_now(&clock));
+    log_sink sink = sink_char(print);
+    sink.write(&sink, prefix, (size_t)len);
+    sink.write(&sink, message, strlen(message));
+}
+
+int write_fd(log_sink* sink, const char* data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t done = write(sink->fd, data, len);
+        if (done <= 0)
+        {
+            return 0;
+        }
+        data += done;
+        len -= (size_t)done;
+    }
+    return 1;
+}
+
+/* A closed peer must not kill the process with SIGPIPE */
+int write_socket(log_sink* sink, const char* data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t done = send(sink->fd, data, len, MSG_NOSIGNAL);
+        if (done <= 0)
+        {
+            return 0;
+        }
+        data += done;
+        len -= (size_t)done;
+    }
+    return 1;
+}
+
+int write_ring(log_sink* sink, const char* data, size_t len)
+{
+    log_ring* ring = sink->context;
+    if (ring->capacity == 0)
+    {
+        return 0;
+    }
+    if (len > ring->capacity)
+    {
+        ring->total += len - ring->capacity;
+        data += len - ring->capacity;
+        len = ring->capacity;
+    }
+    size_t at = ring->total % ring->capacity;
+    size_t first = (len < ring->capacity - at) ? len : ring->capacity - at;
+    memcpy(ring->data + at, data, first);
+    memcpy(ring->data, data + first, len - first);
+    ring->total += len;
+    return 1;
+}
+
+int write_char(log_sink* sink, const char* data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        sink->print(data[i]);
+    }
+    return 1;
+}
+
+log_sink sink_stdout()
+{
+    log_sink sink = {write_fd, STDOUT_FILENO, 0, NULL, NULL};
+    return sink;
+}
+
+log_sink sink_file(const char* path)
+{
+    log_sink sink = {write_fd, open(path, O_WRONLY | O_CREAT | O_APPEND, 0644), 1, NULL, NULL};
+    return sink;
+}
+
+log_sink sink_socket(int socket_fd)
+{
+    log_sink sink = {write_socket, socket_fd, 0, NULL, NULL};
+    return sink;
+}
+
+log_sink sink_ring(log_ring* ring)
+{
+    log_sink sink = {write_ring, -1, 0, ring, NULL};
+    return sink;
+}
+
+log_sink sink_char(char (*print) (char))
+{
+    log_sink sink = {write_char, -1, 0, NULL, print};
+    return sink;
+}
+
+void sink_close(log_sink* sink)
+{
+    if (sink->owns_fd && sink->fd >= 0)
+    {
+        close(sink->fd);
+    }
+    sink->fd = -1;
+}
+
+int log_ring_init(log_ring* ring, size_t capacity)
+{
+    ring->data = malloc(capacity);
+    ring->capacity = (ring->data != NULL) ? capacity : 0;
+    ring->total = 0;
+    return ring->data != NULL && capacity > 0;
+}
+
+size_t log_ring_read(const log_ring* ring, char* out)
+{
+    size_t len = (ring->total < ring->capacity) ? ring->total : ring->capacity;
+    size_t start = (len > 0) ? (ring->total - len) % ring->capacity : 0;
+    size_t first = (len < ring->capacity - start) ? len : ring->capacity - start;
+    memcpy(out, ring->data + start, first);
+    memcpy(out + first, ring->data, len - first);
+    return len;
+}
+
+void log_ring_free(log_ring* ring)
+{
+    free(ring->data);
+    ring->data = NULL;
+    ring->capacity = 0;
+}
+
+const char* log_clock_now(log_clock* clock)
+{
+    time_t now = time(NULL);
+    if (now != clock->second || clock->text[0] == '\0')
+    {
+        struct tm parts;
+        strftime(clock->text, sizeof(clock->text), "%H:%M:%S", localtime_r(&now, &parts));
+        clock->second = now;
+    }
+    return clock->text;
+}
+
+void log_writer_init(log_writer* writer, log_sink* sink)
+{
+    writer->sink = sink;
+    writer->clock.second = 0;
+    writer->clock.text[0] = '\0';
+    writer->used = 0;
+}
+
+int log_flush(log_writer* writer)
+{
+    int ok = writer->used == 0 || writer->sink->write(writer->sink, writer->buffer, writer->used);
+    writer->used = 0;
+    return ok;
+}
+
+/*
+    A line that doesn't fit even into an empty buffer goes to the sink
+    right after the prefix, bypassing the buffer
+*/
+int log_line(log_writer* writer, const char* message)
+{
+    size_t len = strlen(message);
+    int newline = len == 0 || message[len - 1] != '\n';
+    size_t prefix = sizeof(Log_prefix) + sizeof(writer->clock.text);
+    size_t need = prefix + len + newline;
+    int ok = 1;
+    if (writer->used + need > Log_buffer_size)
+    {
+        ok = log_flush(writer);
+    }
+    char* at = writer->buffer + writer->used;
+    memcpy(at, Log_prefix " ", sizeof(Log_prefix));
+    memcpy(at + sizeof(Log_prefix), log_clock_now(&writer->clock), sizeof(writer->clock.text) - 1);
+    at[prefix - 1] = ' ';
+    writer->used += prefix;
+    if (need > Log_buffer_size)
+    {
+        ok = log_flush(writer) && ok;
+        ok = writer->sink->write(writer->sink, message, len) && ok;
+        ok = (!newline || writer->sink->write(writer->sink, "\n", 1)) && ok;
+    }
+    else
+    {
+        memcpy(writer->buffer + writer->used, message, len);
+        writer->used += len;
+        if (newline)
+        {
+            writer->buffer[writer->used++] = '\n';
+        }
+    }
+    return ok;
 }
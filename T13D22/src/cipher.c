@@ -1,39 +1,123 @@
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "caesar.h"
+#include "des.h"
+#include "log_levels.h"
 
 #define MAX_PATH_LEN 256
 #define MAX_TEXT_LEN 1024
+#define VIEW_CHUNK (1 << 20)
+#define LOG_NAME "cipher.log"
 
 typedef struct {
     char path[MAX_PATH_LEN];
     int loaded;
+    int tail_only;   // --tail: после добавления выводить только новую строку
+    long last_lines; // --last N: выводить только последние N строк файла
 } Context;
 
 void print_menu() {
     printf("1 - Enter path to file\n");
     printf("2 - Append text to loaded file\n");
+    printf("3 - Encrypt .c and clear .h files in a directory\n");
+    printf("4 - DES encrypt .c and clear .h files in a directory\n");
     printf("-1 - Exit\n");
 }
 
-void read_and_print_file(const char *path) {
-    FILE *file = fopen(path, "r");
-    if (!file) {
-        printf("n/a\n");
-        return;
+#ifdef LOGGING
+#include <stdarg.h>
+
+#include "logger.h"
+
+FILE *log_file = NULL;
+
+// Сборка logging_cipher записывает действия программы в LOG_NAME
+void note(log_level level, const char *format, ...) {
+    char message[MAX_TEXT_LEN + MAX_PATH_LEN];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    logcat(log_file, message, level);
+}
+#else
+#define note(...) ((void)0)
+#endif
+
+// Пишет len байт целиком, повторяя write при частичной записи
+int write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t done = write(fd, data, len < VIEW_CHUNK ? len : VIEW_CHUNK);
+        if (done <= 0) {
+            return 0;
+        }
+        data += done;
+        len -= (size_t)done;
     }
+    return 1;
+}
 
-    int empty = 1;
-    char ch;
-    while ((ch = fgetc(file)) != EOF) {
-        putchar(ch);
-        empty = 0;
+// Выводит байты [from, to) файла: sendfile без копирования в память процесса,
+// а если stdout его не принимает - через mmap крупными блоками
+int print_range(int fd, off_t from, off_t to) {
+    fflush(stdout);
+    off_t offset = from;
+    while (offset < to && sendfile(STDOUT_FILENO, fd, &offset, (size_t)(to - offset)) > 0) {
+    }
+    if (offset >= to) {
+        return 1;
     }
-    fclose(file);
+    char *map = mmap(NULL, (size_t)to, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        return 0;
+    }
+    madvise(map, (size_t)to, MADV_SEQUENTIAL);
+    int ok = write_all(STDOUT_FILENO, map + offset, (size_t)(to - offset));
+    munmap(map, (size_t)to);
+    return ok;
+}
+
+// Начало последних lines строк файла размера size: обратный поиск '\n' по mmap,
+// завершающий перевод строки в конце файла строкой не считается
+off_t last_lines_start(int fd, off_t size, long lines) {
+    char *map = mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        return 0;
+    }
+    size_t end = (size_t)size - (map[size - 1] == '\n');
+    char *found = map + end;
+    while (lines > 0 && found != NULL) {
+        found = memrchr(map, '\n', (size_t)(found - map));
+        lines--;
+    }
+    off_t start = (found != NULL) ? (off_t)(found - map) + 1 : 0;
+    munmap(map, (size_t)size);
+    return start;
+}
 
-    if (empty) {
+void read_and_print_file(const Context *ctx) {
+    int fd = open(ctx->path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || info.st_size == 0) {
         printf("n/a\n");
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
     }
+
+    off_t start = (ctx->last_lines > 0) ? last_lines_start(fd, info.st_size, ctx->last_lines) : 0;
+    print_range(fd, start, info.st_size);
+    close(fd);
 }
 
 void load_file(Context *ctx) {
@@ -42,46 +126,91 @@ void load_file(Context *ctx) {
         return;
     }
     ctx->loaded = 1;
-    read_and_print_file(ctx->path);
+    note(info, "File '%s' open", ctx->path);
+    read_and_print_file(ctx);
     printf("\n");
 }
 
+// Файл открывается один раз: строка дописывается одним write, а после неё
+// выводится либо весь файл, либо (--tail) только дописанный хвост
 void append_to_file(const Context *ctx) {
     if (!ctx->loaded) {
         printf("n/a\n");
         return;
     }
 
-    // Проверяем, существует ли файл
-    FILE *check_file = fopen(ctx->path, "r");
-    if (!check_file) {
+    int fd = open(ctx->path, O_RDWR | O_APPEND);
+    if (fd < 0) {
         printf("n/a\n");
         return;
     }
-    fclose(check_file);
 
     getchar(); // Очищаем буфер после scanf
 
-    char buffer[MAX_TEXT_LEN];
+    char buffer[MAX_TEXT_LEN + 1];
     if (!fgets(buffer, MAX_TEXT_LEN, stdin)) {
         printf("n/a\n");
+        close(fd);
         return;
     }
 
     size_t len = strlen(buffer);
-    if (len > 0 && buffer[len - 1] == '\n') {
-        buffer[len - 1] = '\0';
+    if (len == 0 || buffer[len - 1] != '\n') {
+        buffer[len++] = '\n';
+        buffer[len] = '\0';
     }
+    if (!write_all(fd, buffer, len)) {
+        printf("n/a\n");
+        close(fd);
+        return;
+    }
+    close(fd);
+
+    note(info, "String wrote in the '%s' file", ctx->path);
+    if (ctx->tail_only) {
+        fputs(buffer, stdout);
+    } else {
+        read_and_print_file(ctx);
+    }
+    printf("\n");
+}
 
-    FILE *file = fopen(ctx->path, "a");
-    if (!file) {
+// Путь к каталогу и сдвиг шифра Цезаря вводятся с консоли
+void encrypt_directory() {
+    char dir[MAX_PATH_LEN] = "";
+    int shift, count = -1;
+    if (scanf("%255s", dir) == 1 && scanf("%d", &shift) == 1) {
+        count = caesar_directory(dir, shift, 0);
+    }
+    if (count < 0) {
+        note(error, "Caesar encryption of the '%s' directory failed", dir);
         printf("n/a\n");
         return;
     }
-    fprintf(file, "%s\n", buffer);
-    fclose(file);
+    note(info, "Directory '%s' encrypted with Caesar cipher, %d files", dir, count);
+    printf("\n");
+}
 
-    read_and_print_file(ctx->path);
+// Путь к каталогу и ключ DES из 16 шестнадцатеричных цифр
+void des_encrypt_directory() {
+    char dir[MAX_PATH_LEN] = "", hex[17];
+    uint8_t key[8];
+    int ok = scanf("%255s", dir) == 1 && scanf("%16s", hex) == 1 && strlen(hex) == 16;
+    int next = ok ? getchar() : EOF;
+    ok = ok && (next == EOF || isspace(next)); // ключ длиннее 16 цифр не обрезается молча
+    for (int i = 0; ok && i < 16; i++) {
+        ok = isxdigit((unsigned char)hex[i]);
+    }
+    for (int i = 0; ok && i < 8; i++) {
+        ok = sscanf(hex + 2 * i, "%2hhx", &key[i]) == 1;
+    }
+    int count = ok ? des_directory(dir, key, 0) : -1;
+    if (count < 0) {
+        note(error, "DES encryption of the '%s' directory failed", dir);
+        printf("n/a\n");
+        return;
+    }
+    note(info, "Directory '%s' encrypted with DES, %d files", dir, count);
     printf("\n");
 }
 
@@ -93,6 +222,12 @@ void handle_menu_choice(int choice, Context *ctx) {
         case 2:
             append_to_file(ctx);
             break;
+        case 3:
+            encrypt_directory();
+            break;
+        case 4:
+            des_encrypt_directory();
+            break;
         default:
             printf("n/a\n");
             break;
@@ -101,10 +236,23 @@ void handle_menu_choice(int choice, Context *ctx) {
 
 
 
-int main() {
-    Context ctx = {"", 0};
+// cipher [--tail] [--last N]
+int main(int argc, char **argv) {
+    Context ctx = {"", 0, 0, 0};
     int choice;
 
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tail") == 0) {
+            ctx.tail_only = 1;
+        } else if (strcmp(argv[i], "--last") == 0 && i + 1 < argc) {
+            ctx.last_lines = atol(argv[++i]);
+        }
+    }
+
+#ifdef LOGGING
+    log_file = log_init(LOG_NAME);
+    note(info, "Program started");
+#endif
     while (1) {
         print_menu();
         if (scanf("%d", &choice) != 1) {
@@ -117,5 +265,9 @@ int main() {
         handle_menu_choice(choice, &ctx);
     }
 
+#ifdef LOGGING
+    note(info, "Program finished");
+    log_close(log_file);
+#endif
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,433 @@
+#define _GNU_SOURCE
+#include "des.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <sys/random.h>
+#include <unistd.h>
+
+#include "file_walk.h"
+
+// Таблицы стандарта FIPS 46-3, биты нумеруются с 1 от старшего
+static const uint8_t initial_permutation[64] = {
+    58, 50, 42, 34, 26, 18, 10, 2, 60, 52, 44, 36, 28, 20, 12, 4, 62, 54, 46, 38, 30, 22,
+    14, 6,  64, 56, 48, 40, 32, 24, 16, 8, 57, 49, 41, 33, 25, 17, 9,  1,  59, 51, 43, 35,
+    27, 19, 11, 3,  61, 53, 45, 37, 29, 21, 13, 5, 63, 55, 47, 39, 31, 23, 15, 7};
+
+static const uint8_t permutation_p[32] = {16, 7, 20, 21, 29, 12, 28, 17, 1,  15, 23, 26, 5,  18, 31, 10,
+                                          2,  8, 24, 14, 32, 27, 3,  9,  19, 13, 30, 6,  22, 11, 4,  25};
+
+static const uint8_t permuted_choice_1[56] = {57, 49, 41, 33, 25, 17, 9,  1,  58, 50, 42, 34, 26, 18,
+                                              10, 2,  59, 51, 43, 35, 27, 19, 11, 3,  60, 52, 44, 36,
+                                              63, 55, 47, 39, 31, 23, 15, 7,  62, 54, 46, 38, 30, 22,
+                                              14, 6,  61, 53, 45, 37, 29, 21, 13, 5,  28, 20, 12, 4};
+
+static const uint8_t permuted_choice_2[48] = {14, 17, 11, 24, 1,  5,  3,  28, 15, 6,  21, 10,
+                                              23, 19, 12, 4,  26, 8,  16, 7,  27, 20, 13, 2,
+                                              41, 52, 31, 37, 47, 55, 30, 40, 51, 45, 33, 48,
+                                              44, 49, 39, 56, 34, 53, 46, 42, 50, 36, 29, 32};
+
+static const uint8_t key_shifts[16] = {1, 1, 2, 2, 2, 2, 2, 2, 1, 2, 2, 2, 2, 2, 2, 1};
+
+static const uint8_t sboxes[8][64] = {
+    {14, 4,  13, 1, 2,  15, 11, 8,  3,  10, 6,  12, 5,  9,  0, 7,  0, 15, 7,  4,  14, 2,
+     13, 1,  10, 6, 12, 11, 9,  5,  3,  8,  4,  1,  14, 8,  13, 6, 2,  11, 15, 12, 9,  7,
+     3,  10, 5,  0, 15, 12, 8,  2,  4,  9,  1,  7,  5,  11, 3,  14, 10, 0,  6,  13},
+    {15, 1,  8,  14, 6,  11, 3,  4,  9,  7, 2,  13, 12, 0, 5,  10, 3,  13, 4,  7,  15, 2,
+     8,  14, 12, 0,  1,  10, 6,  9,  11, 5, 0,  14, 7,  11, 10, 4, 13, 1,  5,  8,  12, 6,
+     9,  3,  2,  15, 13, 8,  10, 1,  3,  15, 4,  2,  11, 6,  7,  12, 0,  5,  14, 9},
+    {10, 0,  9,  14, 6,  3,  15, 5,  1,  13, 12, 7,  11, 4,  2,  8,  13, 7,  0,  9,  3,  4,
+     6,  10, 2,  8,  5,  14, 12, 11, 15, 1,  13, 6,  4,  9,  8,  15, 3,  0,  11, 1,  2,  12,
+     5,  10, 14, 7,  1,  10, 13, 0,  6,  9,  8,  7,  4,  15, 14, 3,  11, 5,  2,  12},
+    {7,  13, 14, 3,  0,  6,  9,  10, 1,  2, 8,  5,  11, 12, 4,  15, 13, 8,  11, 5,  6,  15,
+     0,  3,  4,  7,  2,  12, 1,  10, 14, 9, 10, 6,  9,  0,  12, 11, 7,  13, 15, 1,  3,  14,
+     5,  2,  8,  4,  3,  15, 0,  6,  10, 1, 13, 8,  9,  4,  5,  11, 12, 7,  2,  14},
+    {2,  12, 4,  1,  7,  10, 11, 6,  8,  5,  3,  15, 13, 0,  14, 9,  14, 11, 2,  12, 4,  7,
+     13, 1,  5,  0,  15, 10, 3,  9,  8,  6,  4,  2,  1,  11, 10, 13, 7,  8,  15, 9,  12, 5,
+     6,  3,  0,  14, 11, 8,  12, 7,  1,  14, 2,  13, 6,  15, 0,  9,  10, 4,  5,  3},
+    {12, 1,  10, 15, 9,  2,  6,  8,  0,  13, 3,  4,  14, 7,  5,  11, 10, 15, 4,  2,  7,  12,
+     9,  5,  6,  1,  13, 14, 0,  11, 3,  8,  9,  14, 15, 5,  2,  8,  12, 3,  7,  0,  4,  10,
+     1,  13, 11, 6,  4,  3,  2,  12, 9,  5,  15, 10, 11, 14, 1,  7,  6,  0,  8,  13},
+    {4,  11, 2,  14, 15, 0,  8,  13, 3,  12, 9,  7,  5,  10, 6,  1,  13, 0,  11, 7,  4,  9,
+     1,  10, 14, 3,  5,  12, 2,  15, 8,  6,  1,  4,  11, 13, 12, 3,  7,  14, 10, 15, 6,  8,
+     0,  5,  9,  2,  6,  11, 13, 8,  1,  4,  10, 7,  9,  5,  0,  15, 14, 2,  3,  12},
+    {13, 2,  8,  4,  6,  15, 11, 1,  10, 9,  3,  14, 5,  0,  12, 7,  1,  15, 13, 8,  10, 3,
+     7,  4,  12, 5,  6,  11, 0,  14, 9,  2,  7,  11, 4,  1,  9,  12, 14, 2,  0,  6,  10, 13,
+     15, 3,  5,  8,  2,  1,  14, 7,  4,  10, 8,  13, 15, 12, 9,  0,  3,  5,  6,  11}};
+
+// Таблицы, построенные из стандартных при первом обращении
+typedef struct {
+    uint32_t sp[8][64];           // S-блок и P вместе, индекс - 6 бит входа S-блока
+    uint64_t ip[8][256];          // IP по байтам входа
+    uint64_t fp[8][256];          // IP^-1 по байтам входа
+    uint8_t final_order[64];      // IP^-1 как таблица перестановки
+    uint8_t p_target[32];         // номер бита f (с 0), куда P переносит выход S-блока
+    uint64_t truth[8][4];         // бит v - выходной бит m S-блока на входе v
+} DesTables;
+
+static DesTables tables;
+static pthread_once_t tables_once = PTHREAD_ONCE_INIT;
+
+// Собирает n бит: бит k результата (с 1 от старшего) - бит table[k] из in_bits бит входа
+uint64_t permute(uint64_t in, const uint8_t *table, int n, int in_bits) {
+    uint64_t out = 0;
+    for (int k = 0; k < n; k++) {
+        out = (out << 1) | ((in >> (in_bits - table[k])) & 1);
+    }
+    return out;
+}
+
+int sbox_value(int box, int v) { return sboxes[box][(((v >> 4) & 2) | (v & 1)) * 16 + ((v >> 1) & 15)]; }
+
+void build_tables(void) {
+    for (int k = 0; k < 64; k++) {
+        tables.final_order[initial_permutation[k] - 1] = (uint8_t)(k + 1);
+    }
+    for (int k = 0; k < 32; k++) {
+        tables.p_target[permutation_p[k] - 1] = (uint8_t)k;
+    }
+    for (int box = 0; box < 8; box++) {
+        for (int v = 0; v < 64; v++) {
+            uint64_t word = (uint64_t)sbox_value(box, v) << (28 - 4 * box);
+            tables.sp[box][v] = (uint32_t)permute(word, permutation_p, 32, 32);
+            for (int m = 0; m < 4; m++) {
+                tables.truth[box][m] |= (uint64_t)((sbox_value(box, v) >> (3 - m)) & 1) << v;
+            }
+        }
+    }
+    for (int b = 0; b < 8; b++) {
+        for (int v = 0; v < 256; v++) {
+            tables.ip[b][v] = permute((uint64_t)v << (56 - 8 * b), initial_permutation, 64, 64);
+            tables.fp[b][v] = permute((uint64_t)v << (56 - 8 * b), tables.final_order, 64, 64);
+        }
+    }
+}
+
+uint64_t permute_bytes(const uint64_t table[8][256], uint64_t x) {
+    return table[0][x >> 56] | table[1][(x >> 48) & 255] | table[2][(x >> 40) & 255] |
+           table[3][(x >> 32) & 255] | table[4][(x >> 24) & 255] | table[5][(x >> 16) & 255] |
+           table[6][(x >> 8) & 255] | table[7][x & 255];
+}
+
+// Группа i из 6 бит расширения E(R) - биты 4i..4i+5 (с 0, по кругу) R,
+// повёрнутого на 1 вправо; для чётных i это (R >>> 1), для нечётных (R <<< 3)
+// со сдвигами 26, 18, 10, 2. Подключи раскладываются так же
+void des_set_key(des_key *key, const uint8_t raw[8]) {
+    pthread_once(&tables_once, build_tables);
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++) {
+        bits = (bits << 8) | raw[i];
+    }
+    uint64_t halves = permute(bits, permuted_choice_1, 56, 64);
+    uint32_t c = (uint32_t)(halves >> 28), d = (uint32_t)(halves & 0xfffffff);
+    for (int r = 0; r < 16; r++) {
+        int s = key_shifts[r];
+        c = ((c << s) | (c >> (28 - s))) & 0xfffffff;
+        d = ((d << s) | (d >> (28 - s))) & 0xfffffff;
+        uint64_t sub = permute(((uint64_t)c << 28) | d, permuted_choice_2, 48, 56);
+        key->rounds[r][0] = key->rounds[r][1] = 0;
+        for (int i = 0; i < 8; i++) {
+            key->rounds[r][i % 2] |= (uint32_t)((sub >> (42 - 6 * i)) & 63) << (26 - 8 * (i / 2));
+        }
+        for (int j = 0; j < 48; j++) {
+            key->slices[r][j] = ((sub >> (47 - j)) & 1) ? ~0ULL : 0;
+        }
+    }
+}
+
+uint64_t des_rounds(const des_key *key, uint64_t block, int decrypt) {
+    uint64_t x = permute_bytes(tables.ip, block);
+    uint32_t left = (uint32_t)(x >> 32), right = (uint32_t)x;
+    for (int r = 0; r < 16; r++) {
+        const uint32_t *k = key->rounds[decrypt ? 15 - r : r];
+        uint32_t v = ((right >> 1) | (right << 31)) ^ k[0], w = ((right << 3) | (right >> 29)) ^ k[1];
+        uint32_t f = tables.sp[0][v >> 26] | tables.sp[2][(v >> 18) & 63] | tables.sp[4][(v >> 10) & 63] |
+                     tables.sp[6][(v >> 2) & 63] | tables.sp[1][w >> 26] | tables.sp[3][(w >> 18) & 63] |
+                     tables.sp[5][(w >> 10) & 63] | tables.sp[7][(w >> 2) & 63];
+        uint32_t next = left ^ f;
+        left = right;
+        right = next;
+    }
+    return permute_bytes(tables.fp, ((uint64_t)right << 32) | left);
+}
+
+uint64_t des_encrypt_block(const des_key *key, uint64_t block) { return des_rounds(key, block, 0); }
+
+uint64_t des_decrypt_block(const des_key *key, uint64_t block) { return des_rounds(key, block, 1); }
+
+// Транспонирование матрицы 64x64 бит: бит j слова i меняется с битом i слова j
+void transpose64(uint64_t a[64]) {
+    uint64_t mask = 0x00000000ffffffffULL;
+    for (int j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            uint64_t t = ((a[k] >> j) ^ a[k | j]) & mask;
+            a[k] ^= t << j;
+            a[k | j] ^= t;
+        }
+    }
+}
+
+// Бит i слова - блок i; в векторе 64-битные части - независимые пачки по 64
+typedef uint64_t slice_word __attribute__((vector_size(DES_SLICE / 8)));
+
+slice_word select_bits(slice_word a, slice_word b, slice_word s) { return a ^ ((a ^ b) & s); }
+
+// S-блок над 64 блоками сразу. Выход - дерево выборов по битам входа от
+// младшего к старшему: на нижнем уровне все 16 функций двух младших бит
+// готовятся один раз и общие для четырёх выходных бит
+void slice_sbox(int box, const slice_word in[6], slice_word out[4]) {
+    slice_word low[16], minterm[4];
+    minterm[0] = ~in[4] & ~in[5];
+    minterm[1] = ~in[4] & in[5];
+    minterm[2] = in[4] & ~in[5];
+    minterm[3] = in[4] & in[5];
+    low[0] = minterm[0] ^ minterm[0];
+    low[1] = minterm[0];
+    low[2] = minterm[1];
+    low[3] = minterm[0] | minterm[1];
+    for (int n = 4; n < 8; n++) {
+        low[n] = low[n - 4] | minterm[2];
+    }
+    for (int n = 8; n < 16; n++) {
+        low[n] = low[n - 8] | minterm[3];
+    }
+#pragma GCC unroll 4
+    for (int m = 0; m < 4; m++) {
+        uint64_t t = tables.truth[box][m];
+        slice_word a = select_bits(low[t & 15], low[(t >> 4) & 15], in[3]);
+        slice_word b = select_bits(low[(t >> 8) & 15], low[(t >> 12) & 15], in[3]);
+        slice_word c = select_bits(low[(t >> 16) & 15], low[(t >> 20) & 15], in[3]);
+        slice_word d = select_bits(low[(t >> 24) & 15], low[(t >> 28) & 15], in[3]);
+        slice_word e = select_bits(low[(t >> 32) & 15], low[(t >> 36) & 15], in[3]);
+        slice_word f = select_bits(low[(t >> 40) & 15], low[(t >> 44) & 15], in[3]);
+        slice_word g = select_bits(low[(t >> 48) & 15], low[(t >> 52) & 15], in[3]);
+        slice_word h = select_bits(low[(t >> 56) & 15], low[t >> 60], in[3]);
+        a = select_bits(a, b, in[2]);
+        c = select_bits(c, d, in[2]);
+        e = select_bits(e, f, in[2]);
+        g = select_bits(g, h, in[2]);
+        out[m] = select_bits(select_bits(a, c, in[1]), select_bits(e, g, in[1]), in[0]);
+    }
+}
+
+// DES_SLICE блоков за раз; blocks[j] - блок j, на месте
+void slice_blocks(const des_key *key, uint64_t blocks[DES_SLICE], int decrypt) {
+    slice_word bits[64], halves[2][32];
+    uint64_t lane[64];
+    for (int l = 0; l < DES_SLICE / 64; l++) {
+        memcpy(lane, blocks + 64 * l, sizeof(lane));
+        transpose64(lane);
+        for (int k = 0; k < 64; k++) {
+            bits[k][l] = lane[k];
+        }
+    }
+    // теперь bits[63 - b] - бит b (с 0 от старшего) всех блоков
+    for (int k = 0; k < 64; k++) {
+        halves[k / 32][k % 32] = bits[64 - initial_permutation[k]];
+    }
+    slice_word *left = halves[0], *right = halves[1];
+    for (int r = 0; r < 16; r++) {
+        const uint64_t *k = key->slices[decrypt ? 15 - r : r];
+        // с развёрнутым циклом все индексы ниже - константы
+#pragma GCC unroll 8
+        for (int box = 0; box < 8; box++) {
+            slice_word in[6], out[4];
+            for (int m = 0; m < 6; m++) {
+                in[m] = right[(4 * box + m + 31) % 32] ^ k[6 * box + m];
+            }
+            slice_sbox(box, in, out);
+            for (int m = 0; m < 4; m++) {
+                left[tables.p_target[4 * box + m]] ^= out[m];
+            }
+        }
+        slice_word *temp = left;
+        left = right;
+        right = temp;
+    }
+    // перед IP^-1 половины меняются местами: R16 L16
+    for (int k = 0; k < 64; k++) {
+        int source = tables.final_order[k] - 1;
+        bits[63 - k] = (source < 32) ? right[source] : left[source - 32];
+    }
+    for (int l = 0; l < DES_SLICE / 64; l++) {
+        for (int k = 0; k < 64; k++) {
+            lane[k] = bits[k][l];
+        }
+        transpose64(lane);
+        memcpy(blocks + 64 * l, lane, sizeof(lane));
+    }
+}
+
+uint64_t load_block(const uint8_t *data) {
+    uint64_t block = 0;
+    for (int i = 0; i < DES_BLOCK; i++) {
+        block = (block << 8) | data[i];
+    }
+    return block;
+}
+
+void store_block(uint8_t *data, uint64_t block) {
+    for (int i = DES_BLOCK - 1; i >= 0; i--) {
+        data[i] = (uint8_t)block;
+        block >>= 8;
+    }
+}
+
+void ecb_blocks(const des_key *key, uint8_t *data, size_t blocks, int decrypt) {
+    uint64_t batch[DES_SLICE];
+    size_t i = 0;
+    for (; i + DES_SLICE <= blocks; i += DES_SLICE) {
+        for (int j = 0; j < DES_SLICE; j++) {
+            batch[j] = load_block(data + (i + j) * DES_BLOCK);
+        }
+        slice_blocks(key, batch, decrypt);
+        for (int j = 0; j < DES_SLICE; j++) {
+            store_block(data + (i + j) * DES_BLOCK, batch[j]);
+        }
+    }
+    for (; i < blocks; i++) {
+        store_block(data + i * DES_BLOCK, des_rounds(key, load_block(data + i * DES_BLOCK), decrypt));
+    }
+}
+
+void des_ecb_encrypt(const des_key *key, uint8_t *data, size_t blocks) { ecb_blocks(key, data, blocks, 0); }
+
+void des_ecb_decrypt(const des_key *key, uint8_t *data, size_t blocks) { ecb_blocks(key, data, blocks, 1); }
+
+void des_cbc_encrypt(const des_key *key, uint64_t *iv, uint8_t *data, size_t blocks) {
+    uint64_t chain = *iv;
+    for (size_t i = 0; i < blocks; i++) {
+        chain = des_rounds(key, load_block(data + i * DES_BLOCK) ^ chain, 0);
+        store_block(data + i * DES_BLOCK, chain);
+    }
+    *iv = chain;
+}
+
+void des_cbc_decrypt(const des_key *key, uint64_t *iv, uint8_t *data, size_t blocks) {
+    uint64_t cipher[DES_SLICE], plain[DES_SLICE];
+    for (size_t i = 0; i < blocks; i += DES_SLICE) {
+        int count = (blocks - i < DES_SLICE) ? (int)(blocks - i) : DES_SLICE;
+        for (int j = 0; j < count; j++) {
+            cipher[j] = plain[j] = load_block(data + (i + j) * DES_BLOCK);
+        }
+        if (count == DES_SLICE) {
+            slice_blocks(key, plain, 1);
+        } else {
+            for (int j = 0; j < count; j++) {
+                plain[j] = des_rounds(key, plain[j], 1);
+            }
+        }
+        for (int j = 0; j < count; j++) {
+            store_block(data + (i + j) * DES_BLOCK, plain[j] ^ (j ? cipher[j - 1] : *iv));
+        }
+        *iv = cipher[count - 1];
+    }
+}
+
+size_t des_pad(uint8_t *data, size_t len) {
+    size_t fill = DES_BLOCK - len % DES_BLOCK;
+    memset(data + len, (int)fill, fill);
+    return len + fill;
+}
+
+long des_unpad(const uint8_t *data, size_t len) {
+    size_t fill = len ? data[len - 1] : 0;
+    int ok = len % DES_BLOCK == 0 && fill >= 1 && fill <= DES_BLOCK && fill <= len;
+    for (size_t i = 1; ok && i < fill; i++) {
+        ok = data[len - 1 - i] == fill;
+    }
+    return ok ? (long)(len - fill) : -1;
+}
+
+// Читает до size байт, пока файл не кончится. Возвращает число байт или -1
+ssize_t read_full(int fd, uint8_t *data, size_t size) {
+    size_t total = 0;
+    ssize_t got = 1;
+    while (total < size && got > 0) {
+        got = read(fd, data + total, size - total);
+        total += (got > 0) ? (size_t)got : 0;
+    }
+    return (got < 0) ? -1 : (ssize_t)total;
+}
+
+int write_full(int fd, const uint8_t *data, size_t size) {
+    ssize_t put = 1;
+    while (size > 0 && put > 0) {
+        put = write(fd, data, size);
+        data += (put > 0) ? put : 0;
+        size -= (put > 0) ? (size_t)put : 0;
+    }
+    return size == 0;
+}
+
+void crypt_blocks(const des_key *key, enum des_mode mode, uint64_t *iv, uint8_t *data, size_t blocks,
+                  int decrypt) {
+    if (mode == DES_ECB) {
+        ecb_blocks(key, data, blocks, decrypt);
+    } else if (decrypt) {
+        des_cbc_decrypt(key, iv, data, blocks);
+    } else {
+        des_cbc_encrypt(key, iv, data, blocks);
+    }
+}
+
+// Место под дополнение оставляется в конце буфера
+int des_encrypt_stream(int src, int dst, const des_key *key, enum des_mode mode, uint64_t iv, uint8_t *buffer,
+                       size_t size) {
+    size_t chunk = size - DES_BLOCK;
+    int ok = 1, last = 0;
+    if (mode == DES_CBC) {
+        store_block(buffer, iv);
+        ok = write_full(dst, buffer, DES_BLOCK);
+    }
+    while (ok && !last) {
+        ssize_t got = read_full(src, buffer, chunk);
+        ok = got >= 0;
+        last = !ok || (size_t)got < chunk;
+        size_t len = (ok && last) ? des_pad(buffer, (size_t)got) : (size_t)got;
+        if (ok) {
+            crypt_blocks(key, mode, &iv, buffer, len / DES_BLOCK, 0);
+            ok = write_full(dst, buffer, len);
+        }
+    }
+    return ok;
+}
+
+// Последний блок придерживается в начале буфера до конца файла: только по нему
+// видно дополнение
+int des_decrypt_stream(int src, int dst, const des_key *key, enum des_mode mode, uint8_t *buffer,
+                       size_t size) {
+    uint64_t iv = 0;
+    int ok = 1, held = 0, last = 0;
+    if (mode == DES_CBC) {
+        ok = read_full(src, buffer, DES_BLOCK) == DES_BLOCK;
+        iv = load_block(buffer);
+    }
+    while (ok && !last) {
+        ssize_t got = read_full(src, buffer + DES_BLOCK, size - DES_BLOCK);
+        ok = got >= 0 && got % DES_BLOCK == 0 && (held || got > 0);
+        last = got == 0;
+        if (ok && !last) {
+            crypt_blocks(key, mode, &iv, buffer + DES_BLOCK, (size_t)got / DES_BLOCK, 1);
+            size_t from = held ? 0 : DES_BLOCK;
+            ok = write_full(dst, buffer + from, (size_t)got - from);
+            memcpy(buffer, buffer + got, DES_BLOCK);
+            held = 1;
+        }
+    }
+    long len = ok ? des_unpad(buffer, DES_BLOCK) : -1;
+    return len >= 0 && write_full(dst, buffer, (size_t)len);
+}
+
+int des_file_stream(int src, int dst, const void *context, char *block) {
+    uint64_t iv;
+    int ok = getrandom(&iv, sizeof(iv), 0) == (ssize_t)sizeof(iv);
+    return ok && des_encrypt_stream(src, dst, (const des_key *)context, DES_CBC, iv, (uint8_t *)block,
+                                    WALK_BLOCK);
+}
+
+int des_directory(const char *dir, const uint8_t raw_key[8], int threads) {
+    des_key key;
+    des_set_key(&key, raw_key);
+    return walk_directory(dir, des_file_stream, &key, threads);
+}
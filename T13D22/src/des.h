@@ -0,0 +1,65 @@
+#ifndef DES_H
+#define DES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DES_BLOCK 8
+
+// Блоков в пачке побитового пути: по 64 на каждую 64-битную часть вектора
+#if defined(__AVX2__)
+#define DES_SLICE 256
+#elif defined(__SSE2__)
+#define DES_SLICE 128
+#else
+#define DES_SLICE 64
+#endif
+
+enum des_mode { DES_ECB, DES_CBC };
+
+// Раундовые ключи: для табличного пути по два слова на раунд с 6-битными
+// группами подключа, выровненными под выборку из R; для побитового
+// (bitsliced) пути - 48 масок на раунд, 0 или все единицы
+typedef struct {
+    uint32_t rounds[16][2];
+    uint64_t slices[16][48];
+} des_key;
+
+// Ключ - 8 байт, биты чётности не проверяются
+void des_set_key(des_key *key, const uint8_t raw[8]);
+
+// Один блок в порядке байт big-endian (первый байт - старший)
+uint64_t des_encrypt_block(const des_key *key, uint64_t block);
+uint64_t des_decrypt_block(const des_key *key, uint64_t block);
+
+// Блоки по DES_SLICE штук идут через побитовый путь: блоки транспонируются
+// в 64 вектора, S-блоки считаются логическими операциями над всеми блоками сразу;
+// остаток - через табличный путь (S-блок и перестановка P в одной таблице SP)
+void des_ecb_encrypt(const des_key *key, uint8_t *data, size_t blocks);
+void des_ecb_decrypt(const des_key *key, uint8_t *data, size_t blocks);
+
+// CBC: iv обновляется, так что длинный поток можно шифровать частями.
+// Расшифрование не зависит от соседних результатов и тоже идёт пачками
+void des_cbc_encrypt(const des_key *key, uint64_t *iv, uint8_t *data, size_t blocks);
+void des_cbc_decrypt(const des_key *key, uint64_t *iv, uint8_t *data, size_t blocks);
+
+// Дополнение PKCS#7 до кратного DES_BLOCK: дописывает 1..8 байт, в data должно
+// быть место. Возвращает новую длину
+size_t des_pad(uint8_t *data, size_t len);
+
+// Длина без дополнения или -1, если дополнение испорчено
+long des_unpad(const uint8_t *data, size_t len);
+
+// Потоковое шифрование файла: буфер buffer размера size (кратен DES_BLOCK,
+// не меньше 2 * DES_BLOCK), PKCS#7 в конце. В режиме CBC первым блоком выхода
+// пишется iv. Возвращают 1 при успехе
+int des_encrypt_stream(int src, int dst, const des_key *key, enum des_mode mode, uint64_t iv, uint8_t *buffer,
+                       size_t size);
+int des_decrypt_stream(int src, int dst, const des_key *key, enum des_mode mode, uint8_t *buffer,
+                       size_t size);
+
+// Шифрует DES-CBC со случайным iv все .c файлы каталога и очищает все .h
+// (см. walk_directory). Возвращает число обработанных файлов или -1
+int des_directory(const char *dir, const uint8_t raw_key[8], int threads);
+
+#endif
@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "des.h"
+
+#define BENCH_BYTES (8 << 20)
+#define BENCH_ROUNDS 5
+
+typedef struct {
+    uint64_t key;
+    uint64_t plain;
+    uint64_t cipher;
+} Vector;
+
+// Известные пары: пример из описания стандарта, вектор с нулевым выходом и
+// "Now is t" из FIPS 81
+static const Vector vectors[] = {{0x133457799BBCDFF1ULL, 0x0123456789ABCDEFULL, 0x85E813540F0AB405ULL},
+                                 {0x0E329232EA6D0D73ULL, 0x8787878787878787ULL, 0x0000000000000000ULL},
+                                 {0x0123456789ABCDEFULL, 0x4E6F772069732074ULL, 0x3FA40E8A984D4815ULL}};
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void key_bytes(uint64_t value, uint8_t raw[8]) {
+    for (int i = 7; i >= 0; i--) {
+        raw[i] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+int check_vectors() {
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        uint8_t raw[8], data[DES_SLICE * DES_BLOCK];
+        des_key key;
+        key_bytes(vectors[i].key, raw);
+        des_set_key(&key, raw);
+        ok = ok && des_encrypt_block(&key, vectors[i].plain) == vectors[i].cipher &&
+             des_decrypt_block(&key, vectors[i].cipher) == vectors[i].plain;
+        // тот же блок 64 раза - через побитовый путь
+        for (int j = 0; j < DES_SLICE; j++) {
+            key_bytes(vectors[i].plain, data + j * DES_BLOCK);
+        }
+        des_ecb_encrypt(&key, data, DES_SLICE);
+        for (int j = 0; j < DES_SLICE; j++) {
+            uint8_t expect[8];
+            key_bytes(vectors[i].cipher, expect);
+            ok = ok && memcmp(data + j * DES_BLOCK, expect, DES_BLOCK) == 0;
+        }
+    }
+    // FIPS 81, CBC
+    const char *text = "Now is the time for all ";
+    const uint64_t expect[3] = {0xe5c7cdde872bf27cULL, 0x43e934008c389c0fULL, 0x683788499a7c05f6ULL};
+    uint8_t raw[8], data[24];
+    uint64_t iv = 0x1234567890abcdefULL;
+    des_key key;
+    key_bytes(0x0123456789abcdefULL, raw);
+    des_set_key(&key, raw);
+    memcpy(data, text, 24);
+    des_cbc_encrypt(&key, &iv, data, 3);
+    for (int j = 0; j < 3; j++) {
+        uint8_t block[8];
+        key_bytes(expect[j], block);
+        ok = ok && memcmp(data + 8 * j, block, 8) == 0;
+    }
+    iv = 0x1234567890abcdefULL;
+    des_cbc_decrypt(&key, &iv, data, 3);
+    return ok && memcmp(data, text, 24) == 0;
+}
+
+uint64_t load_native(const uint8_t *data) {
+    uint64_t block;
+    memcpy(&block, data, sizeof(block));
+    return block;
+}
+
+void keep_best(double *best, double start) {
+    double seconds = now_seconds() - start;
+    *best = (seconds < *best) ? seconds : *best;
+}
+
+void report(const char *name, double seconds) {
+    printf("%-22s %7.1f MB/s\n", name, BENCH_BYTES / seconds / 1e6);
+}
+
+int main() {
+    uint8_t *data = malloc(BENCH_BYTES), *copy = malloc(BENCH_BYTES), raw[8];
+    if (data == NULL || copy == NULL) {
+        printf("n/a\n");
+    } else {
+        printf("test vectors: %s\n", check_vectors() ? "ok" : "MISMATCH");
+        des_key key;
+        key_bytes(0x133457799BBCDFF1ULL, raw);
+        des_set_key(&key, raw);
+        for (size_t i = 0; i < BENCH_BYTES; i++) {
+            data[i] = (uint8_t)(i * 131 + 7);
+        }
+        memcpy(copy, data, BENCH_BYTES);
+        size_t blocks = BENCH_BYTES / DES_BLOCK;
+
+        double best[5] = {1e9, 1e9, 1e9, 1e9, 1e9};
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            double start = now_seconds();
+            for (size_t i = 0; i < blocks; i++) {
+                uint64_t block = des_encrypt_block(&key, load_native(data + i * DES_BLOCK));
+                memcpy(data + i * DES_BLOCK, &block, DES_BLOCK);
+            }
+            keep_best(&best[0], start);
+            for (size_t i = 0; i < blocks; i++) {
+                uint64_t block = des_decrypt_block(&key, load_native(data + i * DES_BLOCK));
+                memcpy(data + i * DES_BLOCK, &block, DES_BLOCK);
+            }
+            start = now_seconds();
+            des_ecb_encrypt(&key, data, blocks);
+            keep_best(&best[1], start);
+            start = now_seconds();
+            des_ecb_decrypt(&key, data, blocks);
+            keep_best(&best[2], start);
+            uint64_t iv = 42;
+            start = now_seconds();
+            des_cbc_encrypt(&key, &iv, data, blocks);
+            keep_best(&best[3], start);
+            iv = 42;
+            start = now_seconds();
+            des_cbc_decrypt(&key, &iv, data, blocks);
+            keep_best(&best[4], start);
+        }
+        report("table, block by block", best[0]);
+        report("ecb, bitsliced", best[1]);
+        report("ecb decrypt, bitsliced", best[2]);
+        report("cbc encrypt", best[3]);
+        report("cbc decrypt", best[4]);
+        printf("round trip: %s\n", memcmp(data, copy, BENCH_BYTES) ? "MISMATCH" : "ok");
+    }
+    free(data);
+    free(copy);
+    return 0;
+}
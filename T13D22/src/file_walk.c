@@ -0,0 +1,146 @@
+#define _GNU_SOURCE
+#include "file_walk.h"
+
+#include <fcntl.h>
+#include <ftw.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define WALK_DEPTH 32
+
+typedef struct {
+    char **paths;
+    int count;
+    int capacity;
+} FileList;
+
+typedef struct {
+    const FileList *files;
+    stream_action action;
+    const void *context;
+    int next;
+    int failed;
+    pthread_mutex_t lock;
+} Job;
+
+// Пропускает файл через action во временный path.XXXXXX в том же каталоге и rename поверх
+int replace_file(const char *path, const Job *job, char *block) {
+    size_t len = strlen(path);
+    char *temp = malloc(len + 8);
+    int src = open(path, O_RDONLY), dst = -1, ok = 0;
+    struct stat info;
+    if (temp != NULL && src >= 0 && fstat(src, &info) == 0) {
+        memcpy(temp, path, len);
+        memcpy(temp + len, ".XXXXXX", 8);
+        dst = mkstemp(temp);
+    }
+    if (dst >= 0) {
+        ok = job->action(src, dst, job->context, block) && fchmod(dst, info.st_mode & 07777) == 0;
+        ok = close(dst) == 0 && ok;
+        ok = ok && rename(temp, path) == 0;
+        if (!ok) {
+            unlink(temp);
+        }
+    }
+    if (src >= 0) {
+        close(src);
+    }
+    free(temp);
+    return ok;
+}
+
+int has_suffix(const char *path, const char *suffix) {
+    size_t len = strlen(path), suffix_len = strlen(suffix);
+    return len >= suffix_len && strcmp(path + len - suffix_len, suffix) == 0;
+}
+
+int process_file(const char *path, const Job *job, char *block) {
+    return has_suffix(path, ".c") ? replace_file(path, job, block) : truncate(path, 0) == 0;
+}
+
+void *worker_main(void *arg) {
+    Job *job = arg;
+    char *block = malloc(WALK_BLOCK);
+    int index = 0, failed = block == NULL;
+    while (block != NULL && index < job->files->count) {
+        pthread_mutex_lock(&job->lock);
+        index = job->next++;
+        pthread_mutex_unlock(&job->lock);
+        if (index < job->files->count && !process_file(job->files->paths[index], job, block)) {
+            failed = 1;
+        }
+    }
+    pthread_mutex_lock(&job->lock);
+    job->failed |= failed;
+    pthread_mutex_unlock(&job->lock);
+    free(block);
+    return NULL;
+}
+
+// nftw не передаёт пользовательский контекст, поэтому список - статический
+static FileList walk_list;
+
+int collect(const char *path, const struct stat *info, int type, struct FTW *walk) {
+    (void)info;
+    (void)walk;
+    int keep = type == FTW_F && (has_suffix(path, ".c") || has_suffix(path, ".h"));
+    if (keep && walk_list.count == walk_list.capacity) {
+        int capacity = walk_list.capacity ? walk_list.capacity * 2 : 64;
+        char **paths = realloc(walk_list.paths, capacity * sizeof(char *));
+        if (paths == NULL) {
+            return 1;
+        }
+        walk_list.paths = paths;
+        walk_list.capacity = capacity;
+    }
+    if (keep) {
+        walk_list.paths[walk_list.count] = strdup(path);
+        if (walk_list.paths[walk_list.count] == NULL) {
+            return 1;
+        }
+        walk_list.count++;
+    }
+    return 0;
+}
+
+void run_workers(Job *job, int threads) {
+    pthread_t ids[WALK_MAX_THREADS];
+    int started[WALK_MAX_THREADS];
+    for (int i = 1; i < threads; i++) {
+        started[i] = pthread_create(&ids[i], NULL, worker_main, job) == 0;
+    }
+    worker_main(job);
+    for (int i = 1; i < threads; i++) {
+        if (started[i]) {
+            pthread_join(ids[i], NULL);
+        }
+    }
+}
+
+int walk_directory(const char *dir, stream_action action, const void *context, int threads) {
+    FileList empty = {NULL, 0, 0};
+    walk_list = empty;
+    int walked = nftw(dir, collect, WALK_DEPTH, FTW_PHYS) == 0;
+
+    Job job = {&walk_list, action, context, 0, !walked, PTHREAD_MUTEX_INITIALIZER};
+    if (threads <= 0) {
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    threads = threads > WALK_MAX_THREADS ? WALK_MAX_THREADS : (threads < 1 ? 1 : threads);
+    threads = threads > walk_list.count ? (walk_list.count > 0 ? walk_list.count : 1) : threads;
+    if (walked) {
+        run_workers(&job, threads);
+    }
+
+    int result = job.failed ? -1 : walk_list.count;
+    for (int i = 0; i < walk_list.count; i++) {
+        free(walk_list.paths[i]);
+    }
+    free(walk_list.paths);
+    walk_list = empty;
+    return result;
+}
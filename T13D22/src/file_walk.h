@@ -0,0 +1,19 @@
+#ifndef FILE_WALK_H
+#define FILE_WALK_H
+
+#define WALK_BLOCK (1 << 20)
+#define WALK_MAX_THREADS 16
+
+// Переписывает содержимое src в dst; block - буфер потока размера WALK_BLOCK.
+// Возвращает 1 при успехе
+typedef int (*stream_action)(int src, int dst, const void *context, char *block);
+
+// Обходит каталог dir и его подкаталоги: каждый .c файл пропускается через
+// action во временный файл path.XXXXXX рядом с ним, который получает права
+// оригинала и атомарно заменяет его через rename; каждый .h очищается.
+// Файлы раздаются потокам (threads <= 0 - по числу ядер). Возвращает число
+// обработанных файлов или -1, если каталог не открылся или хотя бы один файл
+// не удалось обработать
+int walk_directory(const char *dir, stream_action action, const void *context, int threads);
+
+#endif
@@ -0,0 +1,245 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "log_format.h"
+#include "log_lz.h"
+#include "logger.h"
+
+#define BENCH_MESSAGES 200000
+#define BENCH_MAX_THREADS 4
+#define BENCH_SEGMENT (1 << 20)
+#define BENCH_KEEP 3
+
+enum mode { MODE_NAIVE, MODE_TEXT, MODE_BINARY, MODE_ROTATE };
+
+typedef struct {
+    FILE *file;
+    int id;
+    enum mode mode;
+    double *latency;
+} Worker;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Прямолинейный вариант для сравнения: localtime, fprintf и fflush на каждое сообщение
+int naive_logcat(FILE *file, const char *message, log_level level) {
+    static const char *const names[] = {"DEBUG", "TRACE", "INFO", "WARNING", "ERROR"};
+    time_t now = time(NULL);
+    struct tm parts;
+    char stamp[16];
+    strftime(stamp, sizeof(stamp), "%H:%M:%S", localtime_r(&now, &parts));
+    return fprintf(file, "[%s] %s %s\n", names[level], stamp, message) > 0 && fflush(file) == 0;
+}
+
+// Время вызова вместе с форматированием сообщения
+void *worker_main(void *arg) {
+    Worker *worker = arg;
+    char message[64];
+    for (int i = 0; i < BENCH_MESSAGES; i++) {
+        double start = now_seconds();
+        if (worker->mode == MODE_NAIVE) {
+            snprintf(message, sizeof(message), "worker %d message %d", worker->id, i);
+            naive_logcat(worker->file, message, info);
+        } else {
+            LOGCATF(worker->file, info, "worker %d message %d", worker->id, i);
+        }
+        worker->latency[i] = now_seconds() - start;
+    }
+    return NULL;
+}
+
+// Задержки ниже включают цену пары now_seconds; её стоит вычесть
+double timer_overhead() {
+    double best = 1;
+    for (int i = 0; i < BENCH_MESSAGES; i++) {
+        double start = now_seconds(), spent = now_seconds() - start;
+        best = (spent < best) ? spent : best;
+    }
+    return best;
+}
+
+int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Строк столько, сколько сообщений, и у каждого потока номера идут по порядку
+int check_file(const char *path, int threads) {
+    FILE *file = fopen(path, "r");
+    int next[BENCH_MAX_THREADS] = {0}, lines = 0, ok = file != NULL;
+    char line[128];
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        int id, index;
+        const char *text = strstr(line, "worker ");
+        ok = text != NULL && sscanf(text, "worker %d message %d", &id, &index) == 2 && id >= 0 &&
+             id < threads && index == next[id]++;
+        lines++;
+    }
+    if (file != NULL) {
+        fclose(file);
+    }
+    return ok && lines == threads * BENCH_MESSAGES;
+}
+
+// Двоичный лог проверяется после перевода в текст
+int check_binary(const char *path, int threads) {
+    char text[] = "/tmp/log_bench_text_XXXXXX";
+    int fd = mkstemp(text), ok = 0;
+    FILE *out = (fd >= 0) ? fdopen(fd, "w") : NULL;
+    if (out != NULL) {
+        ok = log_decode(path, out);
+        ok = fclose(out) == 0 && ok && check_file(text, threads);
+    }
+    if (fd >= 0) {
+        unlink(text);
+    }
+    return ok;
+}
+
+// Сегменты path.1.lz, path.2.lz, ... и сам path, склеенные по порядку, -
+// это все сообщения без потерь и перестановок. Сегменты удаляются
+int check_rotated(const char *path, int threads) {
+    char text[] = "/tmp/log_bench_text_XXXXXX", segment[64];
+    int fd = mkstemp(text), ok = 0, count = 0;
+    FILE *out = (fd >= 0) ? fdopen(fd, "w") : NULL;
+    long long packed = 0;
+    if (out != NULL) {
+        ok = 1;
+        for (int seq = 1; ok && snprintf(segment, sizeof(segment), "%s.%d.lz", path, seq) > 0 &&
+                          access(segment, F_OK) == 0;
+             seq++) {
+            FILE *file = fopen(segment, "rb");
+            ok = file != NULL && fseek(file, 0, SEEK_END) == 0;
+            packed += ok ? ftell(file) : 0;
+            if (file != NULL) {
+                fclose(file);
+            }
+            ok = ok && lz_decompress_file(segment, out);
+            unlink(segment);
+            count++;
+        }
+        long long raw = ftell(out);
+        FILE *last = fopen(path, "rb");
+        char buffer[1 << 16];
+        size_t got;
+        while (last != NULL && (got = fread(buffer, 1, sizeof(buffer), last)) > 0) {
+            fwrite(buffer, 1, got, out);
+        }
+        if (last != NULL) {
+            fclose(last);
+        }
+        ok = fclose(out) == 0 && ok && check_file(text, threads);
+        printf(" %d segments, %.1fx smaller", count, (double)raw / (double)(packed > 0 ? packed : 1));
+    }
+    if (fd >= 0) {
+        unlink(text);
+    }
+    return ok;
+}
+
+// Ротация с пределом BENCH_KEEP сегментов: старые должны удаляться
+void bench_retention() {
+    char path[] = "/tmp/log_bench_XXXXXX", segment[64];
+    log_rotation rotation = {BENCH_SEGMENT / 4, 0, 1, BENCH_KEEP, 0};
+    int fd = mkstemp(path), kept = 0, last = 0;
+    FILE *file = (fd >= 0) ? log_init_rotating(path, &rotation) : NULL;
+    if (file != NULL) {
+        for (int i = 0; i < BENCH_MESSAGES; i++) {
+            LOGCATF(file, info, "worker %d message %d", 0, i);
+        }
+        log_close(file);
+        for (int seq = 1; seq < 1000; seq++) {
+            snprintf(segment, sizeof(segment), "%s.%d.lz", path, seq);
+            if (access(segment, F_OK) == 0) {
+                kept++;
+                last = seq;
+                unlink(segment);
+            }
+        }
+        printf("retention: %d of %d segments kept, limit %d [%s]\n", kept, last, BENCH_KEEP,
+               kept == BENCH_KEEP ? "ok" : "MISMATCH");
+    }
+    if (fd >= 0) {
+        close(fd);
+        unlink(path);
+    }
+}
+
+void bench(int threads, enum mode mode, double *latency) {
+    static const char *const names[] = {"naive", "async", "binary", "rotate"};
+    log_rotation rotation = {BENCH_SEGMENT, 0, 1, 0, 0};
+    char path[] = "/tmp/log_bench_XXXXXX";
+    int fd = mkstemp(path);
+    FILE *file = NULL;
+    if (fd >= 0) {
+        close(fd);
+        if (mode == MODE_NAIVE) {
+            file = fopen(path, "a");
+        } else if (mode == MODE_ROTATE) {
+            file = log_init_rotating(path, &rotation);
+        } else {
+            file = (mode == MODE_TEXT) ? log_init(path) : log_init_binary(path);
+        }
+    }
+    if (file != NULL) {
+        pthread_t ids[BENCH_MAX_THREADS];
+        Worker workers[BENCH_MAX_THREADS];
+        double start = now_seconds();
+        for (int t = 0; t < threads; t++) {
+            Worker worker = {file, t, mode, latency + (size_t)t * BENCH_MESSAGES};
+            workers[t] = worker;
+            pthread_create(&ids[t], NULL, worker_main, &workers[t]);
+        }
+        for (int t = 0; t < threads; t++) {
+            pthread_join(ids[t], NULL);
+        }
+        double calls = now_seconds() - start;
+        if (mode == MODE_NAIVE) {
+            fclose(file);
+        } else {
+            log_close(file);
+        }
+        double total = now_seconds() - start;
+        size_t n = (size_t)threads * BENCH_MESSAGES;
+        qsort(latency, n, sizeof(double), compare_doubles);
+        printf("%-6s %d threads: %5.2f M msg/s calls, %5.2f M msg/s on disk, p50 %5.0f ns, p99 %6.0f ns",
+               names[mode], threads, n / calls / 1e6, n / total / 1e6, latency[n / 2] * 1e9,
+               latency[n * 99 / 100] * 1e9);
+        int ok;
+        if (mode == MODE_ROTATE) {
+            ok = check_rotated(path, threads);
+        } else {
+            ok = (mode == MODE_BINARY) ? check_binary(path, threads) : check_file(path, threads);
+        }
+        printf(" [%s]\n", ok ? "ok" : "MISMATCH");
+    }
+    if (fd >= 0) {
+        unlink(path);
+    }
+}
+
+int main() {
+    double *latency = malloc(sizeof(double) * BENCH_MESSAGES * BENCH_MAX_THREADS);
+    if (latency == NULL) {
+        printf("n/a\n");
+    } else {
+        printf("timer overhead: %.0f ns\n", timer_overhead() * 1e9);
+        for (int threads = 1; threads <= BENCH_MAX_THREADS; threads *= BENCH_MAX_THREADS) {
+            bench(threads, MODE_NAIVE, latency);
+            bench(threads, MODE_TEXT, latency);
+            bench(threads, MODE_BINARY, latency);
+            bench(threads, MODE_ROTATE, latency);
+        }
+        bench_retention();
+    }
+    free(latency);
+    return 0;
+}
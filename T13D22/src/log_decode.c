@@ -0,0 +1,23 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "log_format.h"
+#include "log_lz.h"
+
+int has_suffix(const char *path, const char *suffix) {
+    size_t len = strlen(path), suffix_len = strlen(suffix);
+    return len >= suffix_len && strcmp(path + len - suffix_len, suffix) == 0;
+}
+
+// log_decode file... - печатает текстом двоичные логи (log_init_binary)
+// и сжатые сегменты ротации (*.lz)
+int main(int argc, char **argv) {
+    int ok = argc > 1;
+    for (int i = 1; i < argc && ok; i++) {
+        ok = has_suffix(argv[i], ".lz") ? lz_decompress_file(argv[i], stdout) : log_decode(argv[i], stdout);
+    }
+    if (!ok) {
+        printf("n/a\n");
+    }
+    return ok ? 0 : 1;
+}
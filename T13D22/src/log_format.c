@@ -0,0 +1,193 @@
+#define _GNU_SOURCE
+#include "log_format.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static const char *const level_names[] = {"DEBUG", "TRACE", "INFO", "WARNING", "ERROR"};
+
+// Длина спецификации, начинающейся с '%', и тип её аргумента (-1 - не поддерживается)
+size_t parse_spec(const char *spec, int *kind) {
+    size_t i = 1;
+    int length = 0, ok = 1;
+    while (strchr("-+ #0'", spec[i]) != NULL && spec[i] != '\0') {
+        i++;
+    }
+    while (spec[i] == '*' || (spec[i] >= '0' && spec[i] <= '9') || spec[i] == '.') {
+        ok = ok && spec[i] != '*';
+        i++;
+    }
+    while (strchr("hlzjtL", spec[i]) != NULL && spec[i] != '\0') {
+        length = length * 128 + spec[i++];
+    }
+    char conversion = spec[i];
+    if (strchr("diouxXc", conversion) != NULL && conversion != '\0') {
+        if (length == 0 || length == 'h' || length == 'h' * 128 + 'h') {
+            *kind = LOG_ARG_INT;
+        } else if (length == 'l') {
+            *kind = LOG_ARG_LONG;
+        } else if (length == 'l' * 128 + 'l' || length == 'j') {
+            *kind = LOG_ARG_LLONG;
+        } else {
+            *kind = (length == 'z' || length == 't') ? LOG_ARG_SIZE : -1;
+        }
+    } else if (strchr("eEfFgGaA", conversion) != NULL && conversion != '\0') {
+        *kind = (length == 0 || length == 'l') ? LOG_ARG_DOUBLE : -1;
+    } else if (conversion == 's' || conversion == 'p') {
+        *kind = (length != 0) ? -1 : (conversion == 's') ? LOG_ARG_STRING : LOG_ARG_POINTER;
+    } else {
+        *kind = -1;
+    }
+    *kind = ok ? *kind : -1;
+    return i + (conversion != '\0');
+}
+
+int log_parse_format(const char *format, uint8_t kinds[LOG_MAX_ARGS]) {
+    int count = 0;
+    while (*format != '\0' && count >= 0) {
+        if (format[0] == '%' && format[1] == '%') {
+            format += 2;
+        } else if (format[0] == '%') {
+            int kind;
+            format += parse_spec(format, &kind);
+            count = (kind < 0 || count == LOG_MAX_ARGS) ? -1 : count;
+            if (count >= 0) {
+                kinds[count++] = (uint8_t)kind;
+            }
+        } else {
+            format++;
+        }
+    }
+    return count;
+}
+
+// Печать одного аргумента; *used - сколько байт args он занял
+int render_arg(char *out, size_t size, const char *spec, int kind, const uint8_t *args, size_t len,
+               size_t *used) {
+    int64_t value = 0;
+    double real = 0;
+    uint32_t text_len = 0;
+    char text[LOG_RECORD_MAX];
+    *used = (kind == LOG_ARG_STRING) ? sizeof(uint32_t) : sizeof(int64_t);
+    if (len < *used) {
+        return snprintf(out, size, "?");
+    }
+    memcpy(&value, args, (kind == LOG_ARG_STRING) ? 0 : sizeof(value));
+    memcpy(&real, args, (kind == LOG_ARG_DOUBLE) ? sizeof(real) : 0);
+    if (kind == LOG_ARG_STRING) {
+        memcpy(&text_len, args, sizeof(text_len));
+        text_len = (text_len <= len - *used && text_len < sizeof(text)) ? text_len : 0;
+        memcpy(text, args + *used, text_len);
+        text[text_len] = '\0';
+        *used += text_len;
+    }
+    int written;
+    switch (kind) {
+        case LOG_ARG_INT:
+            written = snprintf(out, size, spec, (int)value);
+            break;
+        case LOG_ARG_LONG:
+            written = snprintf(out, size, spec, (long)value);
+            break;
+        case LOG_ARG_LLONG:
+            written = snprintf(out, size, spec, (long long)value);
+            break;
+        case LOG_ARG_SIZE:
+            written = snprintf(out, size, spec, (size_t)value);
+            break;
+        case LOG_ARG_DOUBLE:
+            written = snprintf(out, size, spec, real);
+            break;
+        case LOG_ARG_STRING:
+            written = snprintf(out, size, spec, text);
+            break;
+        default:
+            written = snprintf(out, size, spec, (void *)(intptr_t)value);
+            break;
+    }
+    return written;
+}
+
+size_t log_render(char *out, size_t size, const char *format, const uint8_t *args, size_t len) {
+    size_t pos = 0;
+    while (*format != '\0' && pos + 1 < size) {
+        if (format[0] == '%' && format[1] != '%' && format[1] != '\0') {
+            char spec[32];
+            int kind;
+            size_t spec_len = parse_spec(format, &kind), used = 0;
+            spec_len = (spec_len < sizeof(spec)) ? spec_len : sizeof(spec) - 1;
+            memcpy(spec, format, spec_len);
+            spec[spec_len] = '\0';
+            int written = (kind < 0) ? 0 : render_arg(out + pos, size - pos, spec, kind, args, len, &used);
+            pos += (written > 0) ? (size_t)written : 0;
+            pos = (pos < size) ? pos : size - 1;
+            args += used;
+            len -= used;
+            format += spec_len;
+        } else {
+            out[pos++] = *format;
+            format += (format[0] == '%' && format[1] == '%') ? 2 : 1;
+        }
+    }
+    out[pos] = '\0';
+    return pos;
+}
+
+int decode_records(const uint8_t *data, size_t size, FILE *out) {
+    char *formats[LOG_MAX_FORMATS] = {NULL}, line[LOG_RECORD_MAX * 2], stamp[16] = "";
+    int64_t stamp_second = -1;
+    size_t pos = LOG_HEADER;
+    log_record_head head = {0, 0, 0, 0, 0};
+    int ok = 1;
+    while (ok && pos + sizeof(head) <= size) {
+        memcpy(&head, data + pos, sizeof(head));
+        if (head.size == 0) {
+            break;
+        }
+        ok = head.size >= sizeof(head) && head.size <= size - pos && head.format < LOG_MAX_FORMATS;
+        const uint8_t *body = data + pos + sizeof(head);
+        size_t body_len = ok ? head.size - sizeof(head) : 0;
+        if (ok && head.kind == LOG_RECORD_FORMAT) {
+            free(formats[head.format]);
+            formats[head.format] = strndup((const char *)body, body_len);
+        } else if (ok && head.kind == LOG_RECORD_MESSAGE && formats[head.format] != NULL) {
+            int64_t second = (int64_t)(head.ticks / 1000000000ULL);
+            if (second != stamp_second) {
+                time_t value = (time_t)second;
+                struct tm parts;
+                localtime_r(&value, &parts);
+                strftime(stamp, sizeof(stamp), "%H:%M:%S", &parts);
+                stamp_second = second;
+            }
+            log_render(line, sizeof(line), formats[head.format], body, body_len);
+            fprintf(out, "[%s] %s %s\n", level_names[head.level < 5 ? head.level : 0], stamp, line);
+        }
+        pos += (head.size + 7) & ~(size_t)7;
+    }
+    for (int i = 0; i < LOG_MAX_FORMATS; i++) {
+        free(formats[i]);
+    }
+    return ok;
+}
+
+int log_decode(const char *path, FILE *out) {
+    int fd = open(path, O_RDONLY), ok = 0;
+    struct stat info;
+    if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size >= LOG_HEADER) {
+        uint8_t *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+            ok = memcmp(data, LOG_MAGIC, LOG_HEADER) == 0 && decode_records(data, (size_t)info.st_size, out);
+            munmap(data, (size_t)info.st_size);
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    return ok;
+}
@@ -0,0 +1,51 @@
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Двоичный лог: заголовок LOG_MAGIC (8 байт), затем записи, выровненные на 8.
+// Запись - log_record_head и данные; size == 0 - конец (дальше файл не дописан).
+// LOG_RECORD_FORMAT: данные - строка формата с номером format, она всегда
+// раньше первого сообщения с этим номером. LOG_RECORD_MESSAGE: аргументы
+// по порядку - целые, double и указатели по 8 байт, строки - длина (4 байта)
+// и байты без нуля. ticks - наносекунды CLOCK_REALTIME_COARSE
+#define LOG_MAGIC "LOGBIN1"
+#define LOG_HEADER 8
+#define LOG_MAX_ARGS 16
+#define LOG_MAX_FORMATS 4096
+#define LOG_RECORD_MAX 4096
+
+enum log_record_kind { LOG_RECORD_FORMAT = 1, LOG_RECORD_MESSAGE = 2 };
+
+enum log_arg {
+    LOG_ARG_INT,
+    LOG_ARG_LONG,
+    LOG_ARG_LLONG,
+    LOG_ARG_SIZE,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING,
+    LOG_ARG_POINTER
+};
+
+typedef struct {
+    uint32_t size;
+    uint16_t format;
+    uint8_t kind;
+    uint8_t level;
+    uint64_t ticks;
+} log_record_head;
+
+// Типы аргументов printf-формата. Возвращает их число или -1, если формат
+// не поддерживается (* в ширине или точности, %n, больше LOG_MAX_ARGS)
+int log_parse_format(const char *format, uint8_t kinds[LOG_MAX_ARGS]);
+
+// Печатает в out сообщение по формату и упакованным аргументам args длины len.
+// Возвращает длину без нуля (как snprintf, не больше size - 1)
+size_t log_render(char *out, size_t size, const char *format, const uint8_t *args, size_t len);
+
+// Переводит двоичный лог path в строки "[LEVEL] HH:MM:SS message". 1 при успехе
+int log_decode(const char *path, FILE *out);
+
+#endif
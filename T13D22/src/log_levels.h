@@ -1,13 +1,13 @@
 #ifndef LOG_LEVELS
 #define LOG_LEVELS
 
-enum log_level
+typedef enum log_level
 {
     debug,
     trace,
     info,
     warning,
     error
-}
+} log_level;
 
 #endif
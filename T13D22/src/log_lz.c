@@ -0,0 +1,164 @@
+#include "log_lz.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LZ_MIN_MATCH 4
+#define LZ_TAIL 8 // последние байты блока всегда литералы, чтобы читать по 4 байта без проверок
+#define LZ_MAX_OFFSET 65535
+
+size_t lz_bound(size_t n) { return n + n / 255 + 16; }
+
+uint32_t read32(const uint8_t *data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// Длина 15 и больше продолжается байтами по 255 и остатком
+size_t put_length(uint8_t *dst, size_t op, size_t len) {
+    for (len -= 15; len >= 255; len -= 255) {
+        dst[op++] = 255;
+    }
+    dst[op++] = (uint8_t)len;
+    return op;
+}
+
+size_t put_sequence(uint8_t *dst, size_t op, const uint8_t *literals, size_t literal_len, size_t offset,
+                    size_t match_len) {
+    size_t token = op++;
+    size_t match_code = match_len ? match_len - LZ_MIN_MATCH : 0;
+    size_t high = (literal_len < 15) ? literal_len : 15, low = (match_code < 15) ? match_code : 15;
+    dst[token] = (uint8_t)(high << 4 | low);
+    if (literal_len >= 15) {
+        op = put_length(dst, op, literal_len);
+    }
+    memcpy(dst + op, literals, literal_len);
+    op += literal_len;
+    if (match_len) {
+        dst[op++] = (uint8_t)offset;
+        dst[op++] = (uint8_t)(offset >> 8);
+        if (match_code >= 15) {
+            op = put_length(dst, op, match_code);
+        }
+    }
+    return op;
+}
+
+// Кандидат на совпадение - последняя позиция с тем же хешем 4 байт. На
+// несжимаемых данных шаг поиска растёт с длиной хвоста литералов
+size_t lz_compress(const uint8_t *src, size_t n, uint8_t *dst) {
+    uint32_t *table = calloc(1 << LZ_HASH_BITS, sizeof(uint32_t));
+    size_t ip = 0, anchor = 0, op = 0;
+    while (table != NULL && ip + LZ_MIN_MATCH + LZ_TAIL <= n) {
+        uint32_t sequence = read32(src + ip), hash = (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+        size_t candidate = table[hash];
+        table[hash] = (uint32_t)(ip + 1);
+        int found = candidate != 0 && ip - (candidate - 1) <= LZ_MAX_OFFSET;
+        if (found && read32(src + candidate - 1) == sequence) {
+            size_t match = candidate - 1, len = LZ_MIN_MATCH;
+            while (ip + len < n - LZ_TAIL && src[match + len] == src[ip + len]) {
+                len++;
+            }
+            op = put_sequence(dst, op, src + anchor, ip - anchor, ip - match, len);
+            ip += len;
+            anchor = ip;
+        } else {
+            ip += 1 + ((ip - anchor) >> 6);
+        }
+    }
+    free(table);
+    return put_sequence(dst, op, src + anchor, n - anchor, 0, 0);
+}
+
+// Продолжение длины; -1, если вышли за вход
+long get_length(const uint8_t *src, size_t n, size_t *ip, size_t len) {
+    uint8_t byte = 255;
+    while (len >= 15 && byte == 255 && *ip < n) {
+        byte = src[(*ip)++];
+        len += byte;
+    }
+    return (len >= 15 && byte == 255) ? -1 : (long)len;
+}
+
+long lz_decompress(const uint8_t *src, size_t n, uint8_t *dst, size_t capacity) {
+    size_t ip = 0, op = 0;
+    int ok = 1, done = 0;
+    while (ok && !done && ip < n) {
+        uint8_t token = src[ip++];
+        long literal_len = get_length(src, n, &ip, token >> 4);
+        ok = literal_len >= 0 && (size_t)literal_len <= n - ip && (size_t)literal_len <= capacity - op;
+        if (ok) {
+            memcpy(dst + op, src + ip, (size_t)literal_len);
+            ip += (size_t)literal_len;
+            op += (size_t)literal_len;
+        }
+        done = ip == n;
+        if (ok && !done) {
+            ok = n - ip >= 2;
+            size_t offset = ok ? (size_t)src[ip] | (size_t)src[ip + 1] << 8 : 0;
+            ip += 2;
+            long match_len = ok ? get_length(src, n, &ip, token & 15) : -1;
+            ok = match_len >= 0 && offset > 0 && offset <= op &&
+                 (size_t)match_len + LZ_MIN_MATCH <= capacity - op;
+            for (long i = 0; ok && i < match_len + LZ_MIN_MATCH; i++) {
+                dst[op] = dst[op - offset];
+                op++;
+            }
+        }
+    }
+    return ok ? (long)op : -1;
+}
+
+void put32(uint8_t *data, uint32_t value) { memcpy(data, &value, sizeof(value)); }
+
+int lz_compress_file(const char *from, const char *to) {
+    FILE *in = fopen(from, "rb"), *out = fopen(to, "wb");
+    uint8_t *block = malloc(LZ_BLOCK), *packed = malloc(lz_bound(LZ_BLOCK) + 8);
+    int ok = in != NULL && out != NULL && block != NULL && packed != NULL && fwrite(LZ_MAGIC, 1, 4, out) == 4;
+    size_t got = ok ? LZ_BLOCK : 0;
+    while (ok && got == LZ_BLOCK) {
+        got = fread(block, 1, LZ_BLOCK, in);
+        size_t len = (got > 0) ? lz_compress(block, got, packed + 8) : 0;
+        if (len >= got) {
+            memcpy(packed + 8, block, got);
+            len = got;
+        }
+        put32(packed, (uint32_t)got);
+        put32(packed + 4, (uint32_t)len);
+        ok = !ferror(in) && (got == 0 || fwrite(packed, 1, len + 8, out) == len + 8);
+    }
+    if (in != NULL) {
+        fclose(in);
+    }
+    ok = out != NULL && fclose(out) == 0 && ok;
+    free(block);
+    free(packed);
+    return ok;
+}
+
+int lz_decompress_file(const char *from, FILE *out) {
+    FILE *in = fopen(from, "rb");
+    uint8_t *block = malloc(LZ_BLOCK), *packed = malloc(lz_bound(LZ_BLOCK)), header[8];
+    int ok = in != NULL && block != NULL && packed != NULL && fread(header, 1, 4, in) == 4 &&
+             memcmp(header, LZ_MAGIC, 4) == 0;
+    while (ok && fread(header, 1, 8, in) == 8) {
+        uint32_t raw = read32(header), len = read32(header + 4);
+        ok = raw <= LZ_BLOCK && len <= raw && fread(packed, 1, len, in) == len;
+        long got = -1;
+        if (ok && len == raw) {
+            memcpy(block, packed, len);
+            got = (long)len;
+        } else if (ok) {
+            got = lz_decompress(packed, len, block, raw);
+        }
+        ok = got == (long)raw && fwrite(block, 1, raw, out) == raw;
+    }
+    ok = ok && !ferror(in);
+    if (in != NULL) {
+        fclose(in);
+    }
+    free(block);
+    free(packed);
+    return ok;
+}
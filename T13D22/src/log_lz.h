@@ -0,0 +1,29 @@
+#ifndef LOG_LZ_H
+#define LOG_LZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Сжатие LZ77 в духе LZ4: последовательности "литералы + ссылка назад"
+// (смещение до 64 КиБ, совпадение от 4 байт), без энтропийного кодирования.
+// Файл: LZ_MAGIC, затем блоки до LZ_BLOCK байт - исходная и сжатая длина
+// (по 4 байта) и данные; если сжатие не помогло, блок хранится как есть
+#define LZ_MAGIC "LZS1"
+#define LZ_BLOCK (1 << 20)
+#define LZ_HASH_BITS 14
+
+// Сколько места нужно под сжатые n байт в худшем случае
+size_t lz_bound(size_t n);
+
+size_t lz_compress(const uint8_t *src, size_t n, uint8_t *dst);
+
+// Распаковывает в dst не больше capacity байт. Длина результата или -1,
+// если данные испорчены
+long lz_decompress(const uint8_t *src, size_t n, uint8_t *dst, size_t capacity);
+
+// 1 при успехе
+int lz_compress_file(const char *from, const char *to);
+int lz_decompress_file(const char *from, FILE *out);
+
+#endif
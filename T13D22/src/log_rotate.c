@@ -0,0 +1,215 @@
+#define _GNU_SOURCE
+#include "log_rotate.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "log_lz.h"
+
+int push_segment(log_segment **list, int *count, int *capacity, log_segment segment) {
+    int ok = 1;
+    if (*count == *capacity) {
+        int grown = *capacity ? *capacity * 2 : 16;
+        log_segment *bigger = realloc(*list, grown * sizeof(log_segment));
+        ok = bigger != NULL;
+        if (ok) {
+            *list = bigger;
+            *capacity = grown;
+        }
+    }
+    if (ok) {
+        (*list)[(*count)++] = segment;
+    } else {
+        free(segment.path);
+    }
+    return ok;
+}
+
+long long file_bytes(const char *path) {
+    struct stat info;
+    return (stat(path, &info) == 0) ? (long long)info.st_size : 0;
+}
+
+// Сегмент в хранимые, с сохранением порядка номеров, и удаление самых старых сверх пределов
+void keep_segment(log_archive *archive, log_segment segment) {
+    if (push_segment(&archive->kept, &archive->kept_count, &archive->kept_capacity, segment)) {
+        for (int i = archive->kept_count - 1; i > 0 && archive->kept[i - 1].seq > archive->kept[i].seq; i--) {
+            log_segment temp = archive->kept[i];
+            archive->kept[i] = archive->kept[i - 1];
+            archive->kept[i - 1] = temp;
+        }
+        archive->kept_bytes += segment.bytes;
+    }
+    const log_rotation *policy = &archive->policy;
+    int drop = 0;
+    while (drop < archive->kept_count &&
+           ((policy->keep_segments > 0 && archive->kept_count - drop > policy->keep_segments) ||
+            (policy->keep_bytes > 0 && archive->kept_bytes > policy->keep_bytes))) {
+        unlink(archive->kept[drop].path);
+        archive->kept_bytes -= archive->kept[drop].bytes;
+        free(archive->kept[drop].path);
+        drop++;
+    }
+    archive->kept_count -= drop;
+    memmove(archive->kept, archive->kept + drop, archive->kept_count * sizeof(log_segment));
+}
+
+// Сжатие идёт без блокировки: очередь трогается только под lock
+void *archive_main(void *arg) {
+    log_archive *archive = arg;
+    pthread_mutex_lock(&archive->lock);
+    while (!archive->stop || archive->queued > 0) {
+        if (archive->queued == 0) {
+            pthread_cond_wait(&archive->wake, &archive->lock);
+            continue;
+        }
+        log_segment segment = archive->queue[0];
+        archive->queued--;
+        memmove(archive->queue, archive->queue + 1, archive->queued * sizeof(log_segment));
+        pthread_mutex_unlock(&archive->lock);
+
+        if (archive->policy.compress) {
+            size_t len = strlen(segment.path);
+            char *packed = malloc(len + 8), *temp = malloc(len + 8);
+            if (packed != NULL && temp != NULL) {
+                snprintf(packed, len + 8, "%s.lz", segment.path);
+                snprintf(temp, len + 8, "%s.lz~", segment.path);
+                if (lz_compress_file(segment.path, temp) && rename(temp, packed) == 0) {
+                    unlink(segment.path);
+                    free(segment.path);
+                    segment.path = packed;
+                    packed = NULL;
+                } else {
+                    unlink(temp);
+                }
+            }
+            free(packed);
+            free(temp);
+        }
+        segment.bytes = file_bytes(segment.path);
+
+        pthread_mutex_lock(&archive->lock);
+        keep_segment(archive, segment);
+    }
+    pthread_mutex_unlock(&archive->lock);
+    return NULL;
+}
+
+// base.N или base.N.lz; возвращает N или -1
+long segment_seq(const char *name, const char *base_name, int *packed) {
+    size_t len = strlen(base_name);
+    char *end = NULL;
+    long seq = -1;
+    int numbered = strncmp(name, base_name, len) == 0 && name[len] == '.';
+    if (numbered && name[len + 1] >= '0' && name[len + 1] <= '9') {
+        seq = strtol(name + len + 1, &end, 10);
+    }
+    *packed = end != NULL && strcmp(end, ".lz") == 0;
+    return (end != NULL && (*end == '\0' || *packed)) ? seq : -1;
+}
+
+void scan_segments(log_archive *archive) {
+    char *dir_path = strdup(archive->base);
+    char *slash = (dir_path != NULL) ? strrchr(dir_path, '/') : NULL;
+    const char *base_name = (slash != NULL) ? archive->base + (slash - dir_path) + 1 : archive->base;
+    if (slash != NULL) {
+        slash[slash == dir_path] = '\0';
+    }
+    DIR *dir = (dir_path != NULL) ? opendir(slash != NULL ? dir_path : ".") : NULL;
+    struct dirent *entry;
+    while (dir != NULL && (entry = readdir(dir)) != NULL) {
+        int packed;
+        long seq = segment_seq(entry->d_name, base_name, &packed);
+        size_t len = strlen(archive->base) + strlen(entry->d_name) + 2;
+        char *path = (seq >= 0) ? malloc(len) : NULL;
+        if (path != NULL) {
+            snprintf(path, len, "%.*s%s", (int)(base_name - archive->base), archive->base, entry->d_name);
+            log_segment segment = {path, file_bytes(path), seq};
+            archive->next_seq = (seq >= archive->next_seq) ? seq + 1 : archive->next_seq;
+            if (packed || !archive->policy.compress) {
+                keep_segment(archive, segment);
+            } else {
+                push_segment(&archive->queue, &archive->queued, &archive->queue_capacity, segment);
+            }
+        }
+    }
+    if (dir != NULL) {
+        closedir(dir);
+    }
+    free(dir_path);
+}
+
+int archive_open(log_archive *archive, const char *base, const log_rotation *policy) {
+    memset(archive, 0, sizeof(*archive));
+    archive->base = strdup(base);
+    archive->policy = *policy;
+    archive->next_seq = 1;
+    pthread_mutex_init(&archive->lock, NULL);
+    pthread_cond_init(&archive->wake, NULL);
+    if (archive->base != NULL) {
+        scan_segments(archive);
+    }
+    int ok = archive->base != NULL && pthread_create(&archive->thread, NULL, archive_main, archive) == 0;
+    if (!ok) {
+        archive->stop = 1;
+        archive_close(archive);
+    }
+    return ok;
+}
+
+// Новый base открывается сразу после переименования. Не открылся - сегмент
+// возвращается на место; не вернулся - остаётся несжатым, но в очередь не
+// попадает: в него ещё пишут через старый дескриптор
+int archive_rotate(log_archive *archive) {
+    size_t len = strlen(archive->base) + 24;
+    char *path = malloc(len);
+    int fd = -1;
+    pthread_mutex_lock(&archive->lock);
+    if (path != NULL) {
+        snprintf(path, len, "%s.%ld", archive->base, archive->next_seq);
+    }
+    if (path != NULL && rename(archive->base, path) == 0) {
+        fd = open(archive->base, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) {
+            rename(path, archive->base);
+        }
+        archive->next_seq++;
+    }
+    if (fd >= 0) {
+        log_segment segment = {path, 0, archive->next_seq - 1};
+        push_segment(&archive->queue, &archive->queued, &archive->queue_capacity, segment);
+        pthread_cond_signal(&archive->wake);
+    } else {
+        free(path);
+    }
+    pthread_mutex_unlock(&archive->lock);
+    return fd;
+}
+
+// Поток мог не запуститься (archive_open при ошибке): тогда stop уже стоит
+void archive_close(log_archive *archive) {
+    pthread_mutex_lock(&archive->lock);
+    int running = !archive->stop;
+    archive->stop = 1;
+    pthread_cond_signal(&archive->wake);
+    pthread_mutex_unlock(&archive->lock);
+    if (running) {
+        pthread_join(archive->thread, NULL);
+    }
+    for (int i = 0; i < archive->kept_count; i++) {
+        free(archive->kept[i].path);
+    }
+    for (int i = 0; i < archive->queued; i++) {
+        free(archive->queue[i].path);
+    }
+    free(archive->kept);
+    free(archive->queue);
+    free(archive->base);
+    pthread_mutex_destroy(&archive->lock);
+    pthread_cond_destroy(&archive->wake);
+}
@@ -0,0 +1,53 @@
+#ifndef LOG_ROTATE_H
+#define LOG_ROTATE_H
+
+#include <pthread.h>
+
+// Правила ротации текстового лога; 0 в поле - без ограничения
+typedef struct {
+    long long max_bytes;  // новый сегмент, когда текущий дорос до этого размера
+    long max_seconds;     // или когда он открыт столько секунд
+    int compress;         // сжимать закрытые сегменты (log_lz) в фоне
+    int keep_segments;    // сколько закрытых сегментов хранить
+    long long keep_bytes; // и сколько байт они занимают вместе
+} log_rotation;
+
+typedef struct {
+    char *path;
+    long long bytes;
+    long seq;
+} log_segment;
+
+// Закрытые сегменты лога base: base.1, base.2, ... (base.N.lz после сжатия),
+// номера растут, старые сегменты не переименовываются. Сжатие и удаление
+// сверх пределов делает отдельный поток, так что запись лога их не ждёт
+typedef struct {
+    char *base;
+    log_rotation policy;
+    long next_seq;
+    log_segment *kept; // по возрастанию номера
+    int kept_count;
+    int kept_capacity;
+    long long kept_bytes;
+    log_segment *queue; // ещё не сжатые
+    int queued;
+    int queue_capacity;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int stop;
+} log_archive;
+
+// Находит уже лежащие рядом сегменты (несжатые ставит в очередь на сжатие)
+// и запускает фоновый поток. 1 при успехе
+int archive_open(log_archive *archive, const char *base, const log_rotation *policy);
+
+// Переименовывает base в следующий сегмент, открывает новый пустой base и
+// отдаёт сегмент фоновому потоку. Открытые дескрипторы base продолжают
+// указывать на сегмент. Дескриптор нового base или -1, если ротации не было
+int archive_rotate(log_archive *archive);
+
+// Дожидается сжатия всей очереди и останавливает поток
+void archive_close(log_archive *archive);
+
+#endif
@@ -0,0 +1,521 @@
+#define _GNU_SOURCE
+#include "logger.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "log_format.h"
+
+#define LOG_TEXT (LOG_CELL - sizeof(atomic_size_t))
+#define LOG_IDLE_NS 10000000L
+
+// Ячейка свободна для позиции p, когда seq == p; занята записью, начинающейся
+// в p, когда seq == p + 1. Продолжения записи номер не меняют: их готовность
+// следует из готовности первой ячейки
+typedef struct {
+    atomic_size_t seq;
+    char data[LOG_TEXT];
+} Cell;
+
+typedef struct {
+    int64_t seconds;
+    uint32_t len;
+    uint32_t level;
+} Head;
+
+typedef struct {
+    _Alignas(64) Cell cells[LOG_CELLS];
+    _Alignas(64) atomic_size_t tail; // следующая свободная позиция, общая для всех потоков
+    _Alignas(64) size_t head;        // дальше только фоновый поток
+    FILE *file;
+    pthread_t flusher;
+    atomic_int stop;
+    atomic_int sleeping;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int failed;
+    int64_t stamp_second;
+    char stamp[16];
+    size_t batch_len;
+    char batch[LOG_BATCH];
+    int binary;
+    int rotating;
+    log_archive archive;
+    char *path;
+    long long written; // байт в текущем сегменте
+    int64_t opened;    // когда он начат
+    uint8_t *map;
+    _Alignas(64) atomic_size_t used; // занято байт отображения, вместе с заголовком
+    atomic_uchar defined[LOG_MAX_FORMATS];
+} Log;
+
+typedef struct {
+    const char *format;
+    int count;
+    uint8_t kinds[LOG_MAX_ARGS];
+} Format;
+
+static Log *_Atomic logs[LOG_MAX_FILES];
+static pthread_mutex_t registry = PTHREAD_MUTEX_INITIALIZER;
+
+// Формат 0 - "%s" для logcat; номера общие для всех логов процесса
+static Format formats[LOG_MAX_FORMATS] = {{"%s", 1, {LOG_ARG_STRING}}};
+static int format_count = 1;
+static pthread_mutex_t format_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *const level_names[] = {"DEBUG", "TRACE", "INFO", "WARNING", "ERROR"};
+
+Log *find_log(const FILE *file) {
+    Log *found = NULL;
+    for (int i = 0; i < LOG_MAX_FILES && found == NULL; i++) {
+        Log *log = atomic_load_explicit(&logs[i], memory_order_acquire);
+        found = (log != NULL && log->file == file) ? log : NULL;
+    }
+    return found;
+}
+
+void wake_flusher(Log *log) {
+    pthread_mutex_lock(&log->lock);
+    pthread_cond_signal(&log->wake);
+    pthread_mutex_unlock(&log->lock);
+}
+
+// Занимает count ячеек подряд. Ячейки освобождаются строго по порядку,
+// поэтому достаточно проверить последнюю
+size_t claim_cells(Log *log, size_t count) {
+    size_t pos = atomic_load_explicit(&log->tail, memory_order_relaxed);
+    int claimed = 0;
+    while (!claimed) {
+        Cell *last = &log->cells[(pos + count - 1) & (LOG_CELLS - 1)];
+        size_t seq = atomic_load_explicit(&last->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)(seq - (pos + count - 1));
+        if (diff == 0) {
+            claimed = atomic_compare_exchange_weak_explicit(&log->tail, &pos, pos + count,
+                                                            memory_order_relaxed, memory_order_relaxed);
+        } else {
+            if (diff < 0) {
+                wake_flusher(log);
+                sched_yield();
+            }
+            pos = atomic_load_explicit(&log->tail, memory_order_relaxed);
+        }
+    }
+    return pos;
+}
+
+// Место под запись в отображении или NULL, если лог кончился
+uint8_t *reserve(Log *log, size_t size) {
+    size_t aligned = (size + 7) & ~(size_t)7;
+    size_t pos = atomic_fetch_add_explicit(&log->used, aligned, memory_order_relaxed);
+    return (pos + aligned <= LOG_MAP_SIZE) ? log->map + pos : NULL;
+}
+
+// Строка формата попадает в лог раньше первого сообщения с её номером:
+// флаг ставится только после того, как место под неё занято
+int define_format(Log *log, int id) {
+    int ok = 1;
+    if (!atomic_load_explicit(&log->defined[id], memory_order_acquire)) {
+        pthread_mutex_lock(&log->lock);
+        if (!atomic_load_explicit(&log->defined[id], memory_order_relaxed)) {
+            size_t len = strlen(formats[id].format), limit = LOG_RECORD_MAX - sizeof(log_record_head);
+            len = (len < limit) ? len : limit;
+            log_record_head head = {(uint32_t)(sizeof(head) + len), (uint16_t)id, LOG_RECORD_FORMAT, 0, 0};
+            uint8_t *record = reserve(log, head.size);
+            ok = record != NULL;
+            if (ok) {
+                memcpy(record, &head, sizeof(head));
+                memcpy(record + sizeof(head), formats[id].format, len);
+                atomic_store_explicit(&log->defined[id], 1, memory_order_release);
+            }
+        }
+        pthread_mutex_unlock(&log->lock);
+    }
+    return ok;
+}
+
+void put_word(uint8_t *record, size_t *len, int64_t value) {
+    memcpy(record + *len, &value, sizeof(value));
+    *len += sizeof(value);
+}
+
+// Собирает запись на стеке и одним memcpy кладёт в отображение. Строки
+// обрезаются так, чтобы запись влезла в LOG_RECORD_MAX
+int binary_message(Log *log, int id, log_level level, va_list args) {
+    uint8_t record[LOG_RECORD_MAX];
+    size_t len = sizeof(log_record_head);
+    const Format *format = &formats[id];
+    for (int i = 0; i < format->count; i++) {
+        switch (format->kinds[i]) {
+            case LOG_ARG_INT:
+                put_word(record, &len, va_arg(args, int));
+                break;
+            case LOG_ARG_LONG:
+                put_word(record, &len, va_arg(args, long));
+                break;
+            case LOG_ARG_LLONG:
+                put_word(record, &len, va_arg(args, long long));
+                break;
+            case LOG_ARG_SIZE:
+                put_word(record, &len, (int64_t)va_arg(args, size_t));
+                break;
+            case LOG_ARG_DOUBLE: {
+                double value = va_arg(args, double);
+                memcpy(record + len, &value, sizeof(value));
+                len += sizeof(value);
+                break;
+            }
+            case LOG_ARG_POINTER:
+                put_word(record, &len, (int64_t)(intptr_t)va_arg(args, void *));
+                break;
+            default: {
+                const char *text = va_arg(args, const char *);
+                text = (text != NULL) ? text : "(null)";
+                size_t rest = sizeof(int64_t) * (format->count - i - 1);
+                size_t room = LOG_RECORD_MAX - len - sizeof(uint32_t) - rest;
+                uint32_t text_len = (uint32_t)strnlen(text, room);
+                memcpy(record + len, &text_len, sizeof(text_len));
+                memcpy(record + len + sizeof(text_len), text, text_len);
+                len += sizeof(text_len) + text_len;
+                break;
+            }
+        }
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME_COARSE, &now);
+    log_record_head head = {(uint32_t)len, (uint16_t)id, LOG_RECORD_MESSAGE, (uint8_t)level,
+                            (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec};
+    memcpy(record, &head, sizeof(head));
+    uint8_t *target = define_format(log, id) ? reserve(log, len) : NULL;
+    if (target != NULL) {
+        memcpy(target, record, len);
+    }
+    return target != NULL;
+}
+
+int binary_text(Log *log, log_level level, ...) {
+    va_list args;
+    va_start(args, level);
+    int ok = binary_message(log, 0, level, args);
+    va_end(args);
+    return ok;
+}
+
+int register_format(log_site *site, const char *format) {
+    pthread_mutex_lock(&format_lock);
+    int id = atomic_load(&site->id);
+    if (id == 0) {
+        int count = -1;
+        if (format_count < LOG_MAX_FORMATS) {
+            count = log_parse_format(format, formats[format_count].kinds);
+        }
+        id = (count >= 0) ? format_count++ : -1;
+        if (id > 0) {
+            formats[id].format = format;
+            formats[id].count = count;
+        }
+        atomic_store_explicit(&site->id, id, memory_order_release);
+    }
+    pthread_mutex_unlock(&format_lock);
+    return id;
+}
+
+int log_format(FILE *log_file, log_site *site, log_level level, const char *format, ...) {
+    Log *log = find_log(log_file);
+    int id = atomic_load_explicit(&site->id, memory_order_acquire), ok = log != NULL;
+    id = (id == 0) ? register_format(site, format) : id;
+    va_list args;
+    va_start(args, format);
+    if (ok && log->binary && id > 0) {
+        ok = binary_message(log, id, level, args);
+    } else if (ok) {
+        char text[LOG_RECORD_MAX];
+        vsnprintf(text, sizeof(text), format, args);
+        ok = log_write(log_file, text, level);
+    }
+    va_end(args);
+    return ok;
+}
+
+int log_write(FILE *log_file, const char *message, log_level level) {
+    Log *log = find_log(log_file);
+    if (log == NULL || log->binary) {
+        return log != NULL && binary_text(log, level, message);
+    }
+    size_t len = strlen(message), limit = LOG_CELLS / 2 * LOG_TEXT - sizeof(Head);
+    len = (len < limit) ? len : limit;
+    size_t count = (sizeof(Head) + len + LOG_TEXT - 1) / LOG_TEXT;
+    Head head = {(int64_t)time(NULL), (uint32_t)len, (uint32_t)level};
+    size_t pos = claim_cells(log, count);
+
+    Cell *first = &log->cells[pos & (LOG_CELLS - 1)];
+    size_t done = (len < LOG_TEXT - sizeof(Head)) ? len : LOG_TEXT - sizeof(Head);
+    memcpy(first->data, &head, sizeof(Head));
+    memcpy(first->data + sizeof(Head), message, done);
+    for (size_t i = 1; i < count; i++) {
+        size_t take = (len - done < LOG_TEXT) ? len - done : LOG_TEXT;
+        memcpy(log->cells[(pos + i) & (LOG_CELLS - 1)].data, message + done, take);
+        done += take;
+    }
+    atomic_store_explicit(&first->seq, pos + 1, memory_order_release);
+    if (atomic_load_explicit(&log->sleeping, memory_order_relaxed)) {
+        wake_flusher(log);
+    }
+    return 1;
+}
+
+void flush_batch(Log *log) {
+    size_t done = 0;
+    while (done < log->batch_len && !log->failed) {
+        ssize_t put = write(fileno(log->file), log->batch + done, log->batch_len - done);
+        log->failed = put <= 0;
+        done += (put > 0) ? (size_t)put : 0;
+    }
+    log->written += (long long)done;
+    log->batch_len = 0;
+}
+
+// Новый сегмент начинается только между строками. Старый уходит под другим
+// именем, а дескриптор FILE подменяется новым файлом через dup2 - атомарно для
+// всех, кто им пользуется. Если ротация не удалась, запись идёт дальше
+// в прежний файл, до следующего срока: сообщения не теряются
+void rotate(Log *log, int64_t now) {
+    flush_batch(log);
+    int fd = archive_rotate(&log->archive);
+    if (fd >= 0) {
+        log->failed = log->failed || dup2(fd, fileno(log->file)) < 0;
+        close(fd);
+    }
+    log->written = 0;
+    log->opened = now;
+}
+
+int rotation_due(const Log *log, int64_t now) {
+    long long size = log->written + (long long)log->batch_len;
+    const log_rotation *policy = &log->archive.policy;
+    return log->rotating && size > 0 &&
+           ((policy->max_bytes > 0 && size >= policy->max_bytes) ||
+            (policy->max_seconds > 0 && now - log->opened >= policy->max_seconds));
+}
+
+void append(Log *log, const char *data, size_t len) {
+    while (len > 0) {
+        if (log->batch_len == LOG_BATCH) {
+            flush_batch(log);
+        }
+        size_t take = (len < LOG_BATCH - log->batch_len) ? len : LOG_BATCH - log->batch_len;
+        memcpy(log->batch + log->batch_len, data, take);
+        log->batch_len += take;
+        data += take;
+        len -= take;
+    }
+}
+
+// "HH:MM:SS " пересчитывается через localtime_r раз в секунду
+const char *stamp(Log *log, int64_t seconds) {
+    if (seconds != log->stamp_second) {
+        time_t value = (time_t)seconds;
+        struct tm parts;
+        localtime_r(&value, &parts);
+        strftime(log->stamp, sizeof(log->stamp), "%H:%M:%S ", &parts);
+        log->stamp_second = seconds;
+    }
+    return log->stamp;
+}
+
+// Переносит готовые записи из кольца в пачку. Возвращает их число
+int drain(Log *log) {
+    int records = 0;
+    Cell *first = &log->cells[log->head & (LOG_CELLS - 1)];
+    while (atomic_load_explicit(&first->seq, memory_order_acquire) == log->head + 1) {
+        Head head;
+        memcpy(&head, first->data, sizeof(Head));
+        if (rotation_due(log, head.seconds)) {
+            rotate(log, head.seconds);
+        }
+        const char *name = level_names[head.level < 5 ? head.level : 0];
+        append(log, "[", 1);
+        append(log, name, strlen(name));
+        append(log, "] ", 2);
+        append(log, stamp(log, head.seconds), 9);
+        size_t count = (sizeof(Head) + head.len + LOG_TEXT - 1) / LOG_TEXT;
+        size_t done = (head.len < LOG_TEXT - sizeof(Head)) ? head.len : LOG_TEXT - sizeof(Head);
+        append(log, first->data + sizeof(Head), done);
+        for (size_t i = 1; i < count; i++) {
+            size_t take = (head.len - done < LOG_TEXT) ? head.len - done : LOG_TEXT;
+            append(log, log->cells[(log->head + i) & (LOG_CELLS - 1)].data, take);
+            done += take;
+        }
+        append(log, "\n", 1);
+        for (size_t i = 0; i < count; i++) {
+            Cell *cell = &log->cells[(log->head + i) & (LOG_CELLS - 1)];
+            atomic_store_explicit(&cell->seq, log->head + i + LOG_CELLS, memory_order_release);
+        }
+        log->head += count;
+        first = &log->cells[log->head & (LOG_CELLS - 1)];
+        records++;
+    }
+    return records;
+}
+
+// Пропущенное пробуждение (писатель не увидел sleeping) стоит не больше LOG_IDLE_NS
+void idle(Log *log) {
+    struct timespec until;
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_nsec += LOG_IDLE_NS;
+    until.tv_sec += until.tv_nsec / 1000000000L;
+    until.tv_nsec %= 1000000000L;
+    pthread_mutex_lock(&log->lock);
+    atomic_store(&log->sleeping, 1);
+    Cell *first = &log->cells[log->head & (LOG_CELLS - 1)];
+    if (atomic_load(&first->seq) != log->head + 1 && !atomic_load(&log->stop)) {
+        pthread_cond_timedwait(&log->wake, &log->lock, &until);
+    }
+    atomic_store(&log->sleeping, 0);
+    pthread_mutex_unlock(&log->lock);
+}
+
+// stop читается до разгрузки: всё, что записано до log_close, попадает в файл
+void *flusher_main(void *arg) {
+    Log *log = arg;
+    int stop = 0;
+    while (!stop) {
+        stop = atomic_load(&log->stop);
+        int records = drain(log);
+        flush_batch(log);
+        if (records == 0 && !stop) {
+            idle(log);
+        }
+    }
+    return NULL;
+}
+
+// Останавливает фоновый поток или снимает отображение и обрезает файл по записям
+void stop_log(Log *log) {
+    if (log->binary) {
+        size_t used = atomic_load(&log->used);
+        munmap(log->map, LOG_MAP_SIZE);
+        log->failed = ftruncate(fileno(log->file), (off_t)(used < LOG_MAP_SIZE ? used : LOG_MAP_SIZE)) != 0;
+    } else {
+        atomic_store(&log->stop, 1);
+        wake_flusher(log);
+        pthread_join(log->flusher, NULL);
+    }
+    if (log->rotating) {
+        archive_close(&log->archive);
+    }
+}
+
+// Двоичный лог: разреженный файл на LOG_MAP_SIZE, заголовок и формат 0
+int map_binary(Log *log) {
+    int fd = fileno(log->file);
+    log->map = MAP_FAILED;
+    if (ftruncate(fd, LOG_MAP_SIZE) == 0) {
+        log->map = mmap(NULL, LOG_MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (log->map != MAP_FAILED) {
+        memcpy(log->map, LOG_MAGIC, LOG_HEADER);
+        atomic_init(&log->used, LOG_HEADER);
+        for (int i = 0; i < LOG_MAX_FORMATS; i++) {
+            atomic_init(&log->defined[i], 0);
+        }
+    }
+    return log->map != MAP_FAILED && define_format(log, 0);
+}
+
+FILE *open_log(char *filename, int binary, const log_rotation *rotation) {
+    Log *log = NULL;
+    FILE *file = fopen(filename, binary ? "w+" : "a");
+    int slot = -1, ready = 0;
+    if (file != NULL && posix_memalign((void **)&log, 64, sizeof(Log)) == 0) {
+        for (size_t i = 0; i < LOG_CELLS; i++) {
+            atomic_init(&log->cells[i].seq, i);
+        }
+        atomic_init(&log->tail, 0);
+        atomic_init(&log->stop, 0);
+        atomic_init(&log->sleeping, 0);
+        log->head = log->batch_len = 0;
+        log->file = file;
+        log->failed = 0;
+        log->stamp_second = -1;
+        log->binary = binary;
+        log->rotating = 0;
+        log->path = NULL;
+        struct stat info;
+        log->written = (fstat(fileno(file), &info) == 0) ? (long long)info.st_size : 0;
+        log->opened = (int64_t)time(NULL);
+        pthread_mutex_init(&log->lock, NULL);
+        pthread_cond_init(&log->wake, NULL);
+        if (rotation != NULL) {
+            log->path = strdup(filename);
+            log->rotating = log->path != NULL && archive_open(&log->archive, filename, rotation);
+        }
+        if (binary) {
+            ready = map_binary(log);
+        } else if (rotation == NULL || log->rotating) {
+            ready = pthread_create(&log->flusher, NULL, flusher_main, log) == 0;
+        }
+        pthread_mutex_lock(&registry);
+        for (int i = 0; i < LOG_MAX_FILES && slot < 0 && ready; i++) {
+            slot = (atomic_load(&logs[i]) == NULL) ? i : -1;
+        }
+        if (slot >= 0) {
+            atomic_store_explicit(&logs[slot], log, memory_order_release);
+        }
+        pthread_mutex_unlock(&registry);
+    }
+    if (slot < 0) {
+        if (log != NULL && ready) {
+            stop_log(log);
+        } else if (log != NULL && log->rotating) {
+            archive_close(&log->archive);
+        }
+        if (log != NULL) {
+            free(log->path);
+        }
+        free(log);
+        if (file != NULL) {
+            fclose(file);
+        }
+        file = NULL;
+    }
+    return file;
+}
+
+FILE *log_init(char *filename) { return open_log(filename, 0, NULL); }
+
+FILE *log_init_binary(char *filename) { return open_log(filename, 1, NULL); }
+
+FILE *log_init_rotating(char *filename, const log_rotation *rotation) {
+    return open_log(filename, 0, rotation);
+}
+
+int log_close(FILE *log_file) {
+    Log *log = NULL;
+    pthread_mutex_lock(&registry);
+    for (int i = 0; i < LOG_MAX_FILES && log == NULL; i++) {
+        log = atomic_load(&logs[i]);
+        log = (log != NULL && log->file == log_file) ? log : NULL;
+        if (log != NULL) {
+            atomic_store(&logs[i], NULL);
+        }
+    }
+    pthread_mutex_unlock(&registry);
+    if (log == NULL) {
+        return EOF;
+    }
+    stop_log(log);
+    int result = (fclose(log->file) == 0 && !log->failed) ? 0 : EOF;
+    free(log->path);
+    pthread_mutex_destroy(&log->lock);
+    pthread_cond_destroy(&log->wake);
+    free(log);
+    return result;
+}
@@ -0,0 +1,74 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "log_levels.h"
+#include "log_rotate.h"
+
+// Сообщения ниже этого уровня вырезаются при компиляции: -DLOG_MIN_LEVEL=warning
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL debug
+#endif
+
+#define LOG_MAX_FILES 8
+#define LOG_CELLS 8192 // ячеек в кольце одного лога, степень двойки
+#define LOG_CELL 128   // байт в ячейке вместе с её номером
+#define LOG_BATCH (1 << 16)
+#define LOG_MAP_SIZE (1L << 30) // предел двоичного лога, файл разреженный
+
+// Открывает (дописывает) лог filename и запускает поток, который пишет его
+// на диск. Одновременно открыто не больше LOG_MAX_FILES логов. NULL при ошибке
+FILE *log_init(char *filename);
+
+// Как log_init, но с ротацией (см. log_rotate.h). Сегменты переключает фоновый
+// поток лога между строками, подменяя дескриптор файла, так что logcat этого
+// не ждёт, а строки не теряются и не меняют порядок: конец сегмента N - ровно
+// строка перед началом сегмента N + 1
+FILE *log_init_rotating(char *filename, const log_rotation *rotation);
+
+// Двоичный лог (см. log_format.h): файл перезаписывается и отображается в
+// память целиком, потоки занимают место под записи атомарным сдвигом общего
+// смещения и копируют их прямо в отображение, фонового потока нет.
+// Текст получается потом программой log_decode. Записи сверх LOG_MAP_SIZE
+// теряются (logcat возвращает 0)
+FILE *log_init_binary(char *filename);
+
+// Кладёт сообщение в кольцо лога без блокировок и системных вызовов: потоки
+// занимают ячейки атомарным сдвигом общего счётчика, так что порядок строк
+// в файле - порядок вызовов. Длинное сообщение занимает несколько ячеек
+// подряд (не больше половины кольца, дальше обрезается). Если кольцо полное,
+// вызов ждёт, пока фоновый поток его разгрузит - сообщения не теряются.
+// Фоновый поток пишет строки "[LEVEL] HH:MM:SS message" пачками по LOG_BATCH
+// байт одним write. Возвращает 1 при успехе
+int log_write(FILE *log_file, const char *message, log_level level);
+
+static inline int logcat(FILE *log_file, char *message, log_level level) {
+    return (level >= LOG_MIN_LEVEL) ? log_write(log_file, message, level) : 1;
+}
+
+// Место вызова LOGCATF: номер формата, 0 - ещё не выдан, -1 - формат
+// не поддерживается двоичным логом (такие сообщения форматируются сразу)
+typedef struct {
+    atomic_int id;
+} log_site;
+
+int log_format(FILE *log_file, log_site *site, log_level level, const char *format, ...)
+    __attribute__((format(printf, 4, 5)));
+
+// Сообщение по printf-формату. В двоичном логе вызов пишет только уровень,
+// время, номер формата и сырые аргументы, без форматирования; в текстовом
+// это vsnprintf и logcat
+#define LOGCATF(log_file, level, ...)                                    \
+    do {                                                                 \
+        static log_site logcatf_site;                                    \
+        if ((level) >= LOG_MIN_LEVEL) {                                  \
+            log_format((log_file), &logcatf_site, (level), __VA_ARGS__); \
+        }                                                                \
+    } while (0)
+
+// Дописывает всё из кольца, останавливает поток и закрывает файл. 0 при успехе
+int log_close(FILE *log_file);
+
+#endif